@@ -13,7 +13,7 @@ BLUE='\033[0;34m'
 NC='\033[0m' # No Color
 
 # Source files
-SOURCES="src/main.cpp src/FileScanner.cpp src/Symbol.cpp src/TUI.cpp src/FileWatcher.cpp src/PerformanceLogger.cpp src/AutocompleteEngine.cpp src/JsonExporter.cpp src/LSPServer.cpp"
+SOURCES="src/main.cpp src/FileScanner.cpp src/Symbol.cpp src/TUI.cpp src/FileWatcher.cpp src/PerformanceLogger.cpp src/AutocompleteEngine.cpp src/JsonExporter.cpp src/LSPServer.cpp src/ThreadPool.cpp src/IndexWorker.cpp src/LatencyHistogram.cpp src/ExtensionSet.cpp src/WatchJournal.cpp src/JsonReader.cpp src/LSPTransport.cpp src/DocumentStore.cpp src/WorkspaceIndex.cpp src/IdentifierIndex.cpp src/IndexSnapshot.cpp src/IndexHost.cpp src/NavixDaemon.cpp src/DaemonClient.cpp"
 
 # Common compiler flags
 COMMON_FLAGS="-std=c++17 -O2"
@@ -6,15 +6,127 @@
 #include <cmath>
 #include <sstream>
 #include <cctype>
+#include <cstring>
+#include <string_view>
 #include <filesystem>
 
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NAVIX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Substring kernels for the name arena scan. Each returns the offset of the first
+// occurrence of needle in haystack, or std::string::npos.
+using SubstringFinder = size_t (*)(const char*, size_t, const char*, size_t);
+
+static size_t findSubstringScalar(const char* haystack, size_t length, 
+                                  const char* needle, size_t needleLength) {
+    return std::string_view(haystack, length).find(std::string_view(needle, needleLength));
+}
+
+#ifdef NAVIX_X86_SIMD
+// SIMD variants compare the first and last needle byte against a whole block at once
+// and only run memcmp on candidate positions where both agree.
+__attribute__((target("sse2")))
+static size_t findSubstringSSE2(const char* haystack, size_t length, 
+                                const char* needle, size_t needleLength) {
+    if (needleLength < 2 || length < needleLength) {
+        return findSubstringScalar(haystack, length, needle, needleLength);
+    }
+    
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleLength - 1]);
+    
+    size_t i = 0;
+    for (; i + needleLength - 1 + 16 <= length; i += 16) {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needleLength - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+        
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0) {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    
+    size_t tail = findSubstringScalar(haystack + i, length - i, needle, needleLength);
+    return tail == std::string::npos ? tail : i + tail;
+}
+
+__attribute__((target("avx2")))
+static size_t findSubstringAVX2(const char* haystack, size_t length, 
+                                const char* needle, size_t needleLength) {
+    if (needleLength < 2 || length < needleLength) {
+        return findSubstringScalar(haystack, length, needle, needleLength);
+    }
+    
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needleLength - 1]);
+    
+    size_t i = 0;
+    for (; i + needleLength - 1 + 32 <= length; i += 32) {
+        __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i));
+        __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(haystack + i + needleLength - 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+        
+        while (mask) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0) {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    
+    size_t tail = findSubstringScalar(haystack + i, length - i, needle, needleLength);
+    return tail == std::string::npos ? tail : i + tail;
+}
+#endif
+
+struct SubstringKernel {
+    const char* name;
+    SubstringFinder find;
+};
+
+// Picks the widest kernel the running CPU supports, once per process
+static const SubstringKernel& substringKernel() {
+    static const SubstringKernel kernel = []() -> SubstringKernel {
+#ifdef NAVIX_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return {"avx2", findSubstringAVX2};
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return {"sse2", findSubstringSSE2};
+        }
+#endif
+        return {"scalar", findSubstringScalar};
+    }();
+    return kernel;
+}
+
 AutocompleteEngine::AutocompleteEngine()
     : m_trieRoot(std::make_unique<TrieNode>())
+    , m_removedCount(0)
+    , m_wordStartOffsets(1, 0)
     , m_fuzzyThreshold(0.3)
     , m_prefixWeight(1.0)
+    , m_acronymWeight(0.9)
     , m_fuzzyWeight(0.7)
     , m_substringWeight(0.5)
     , m_logger(nullptr)
+    , m_verbose(true)
+    , m_threadCount(0)
+    , m_parallelThreshold(50000)
+    , m_queryCacheSize(8)
+    , m_queryCacheHits(0)
+    , m_queryCacheRefinements(0)
+    , m_queryCacheMisses(0)
 {
     // Default type boosts
     m_typeBoosts[SymbolType::FUNCTION] = 1.2;
@@ -31,6 +143,8 @@ AutocompleteEngine::AutocompleteEngine()
     m_typeBoosts[SymbolType::SWIFT_PROTOCOL] = 1.15;
 }
 
+AutocompleteEngine::~AutocompleteEngine() = default;
+
 void AutocompleteEngine::buildIndex(const std::vector<Symbol>& symbols) {
     clear();
     
@@ -38,33 +152,176 @@ void AutocompleteEngine::buildIndex(const std::vector<Symbol>& symbols) {
         m_logger->logFileStart("autocomplete-index-build");
     }
     
-    m_symbols = symbols;
+    m_nameOffsets.reserve(symbols.size());
+    m_wordStartOffsets.reserve(symbols.size() + 1);
+    m_removed.reserve(symbols.size());
     
-    // Build trie and symbol map
-    for (size_t i = 0; i < symbols.size(); ++i) {
-        const Symbol& symbol = symbols[i];
-        insertIntoTrie(symbol.name, &symbol);
-        m_symbolMap[toLowerCase(symbol.name)].push_back(i);
+    // Build symbol store, trie, symbol map and name arena
+    for (const Symbol& symbol : symbols) {
+        insertSymbol(symbol);
     }
     
     if (m_logger) {
         m_logger->logFileEnd("autocomplete-index-build", symbols.size(), "autocomplete");
     }
     
-    std::cout << "🔍 Autocomplete index built: " << symbols.size() 
-              << " symbols indexed for fast completion\n";
+    ensureThreadPool();
+    
+    if (m_verbose) {
+        std::cout << "🔍 Autocomplete index built: " << symbols.size() 
+                  << " symbols indexed for fast completion\n";
+    }
 }
 
 void AutocompleteEngine::addSymbol(const Symbol& symbol) {
-    m_symbols.push_back(symbol);
-    insertIntoTrie(symbol.name, &m_symbols.back());
-    m_symbolMap[toLowerCase(symbol.name)].push_back(m_symbols.size() - 1);
+    insertSymbol(symbol);
+    invalidateQueryCache();
+    ensureThreadPool();
+}
+
+size_t AutocompleteEngine::removeFile(const std::string& filePath) {
+    auto it = m_fileSymbols.find(filePath);
+    if (it == m_fileSymbols.end()) {
+        return 0;
+    }
+    
+    std::vector<SymbolId> ids = std::move(it->second);
+    m_fileSymbols.erase(it);
+    
+    for (SymbolId id : ids) {
+        removeSymbol(id);
+    }
+    
+    invalidateQueryCache();
+    
+    // Reclaim space once tombstones dominate the store
+    if (m_removedCount > SymbolStore::CHUNK_SIZE && m_removedCount * 2 > m_symbols.size()) {
+        compact();
+    }
+    
+    return ids.size();
+}
+
+void AutocompleteEngine::updateFile(const std::string& filePath, const std::vector<Symbol>& symbols) {
+    removeFile(filePath);
+    
+    for (const Symbol& symbol : symbols) {
+        insertSymbol(symbol);
+    }
+    
+    invalidateQueryCache();
+    ensureThreadPool();
+}
+
+size_t AutocompleteEngine::renameFile(const std::string& oldPath, const std::string& newPath) {
+    auto existing = m_fileSymbols.find(oldPath);
+    if (existing == m_fileSymbols.end()) {
+        return 0;
+    }
+    if (oldPath == newPath) {
+        return existing->second.size();
+    }
+    
+    // Clear the destination first: removing it may compact the store, which
+    // renumbers every SymbolId including oldPath's
+    removeFile(newPath);
+    
+    // Names are unchanged, so the trie, arena and cached candidates stay valid
+    auto it = m_fileSymbols.find(oldPath);
+    std::vector<SymbolId> ids = std::move(it->second);
+    m_fileSymbols.erase(it);
+    
+    for (SymbolId id : ids) {
+        m_symbols[id].file = newPath;
+    }
+    
+    size_t count = ids.size();
+    m_fileSymbols[newPath] = std::move(ids);
+    return count;
 }
 
 void AutocompleteEngine::clear() {
     m_trieRoot = std::make_unique<TrieNode>();
     m_symbols.clear();
+    m_removed.clear();
+    m_removedCount = 0;
     m_symbolMap.clear();
+    m_fileSymbols.clear();
+    m_nameArena.clear();
+    m_nameOffsets.clear();
+    m_wordStarts.clear();
+    m_wordStartOffsets.assign(1, 0);
+    m_acronymIndex.clear();
+    invalidateQueryCache();
+}
+
+SymbolId AutocompleteEngine::insertSymbol(const Symbol& symbol) {
+    SymbolId id = m_symbols.append(symbol);
+    std::string lowerName = toLowerCase(symbol.name);
+    
+    m_removed.push_back(false);
+    insertIntoTrie(lowerName, id);
+    appendToArena(lowerName);
+    indexWordStarts(symbol.name, id);
+    m_symbolMap[lowerName].push_back(id);
+    m_fileSymbols[symbol.file].push_back(id);
+    
+    return id;
+}
+
+void AutocompleteEngine::removeSymbol(SymbolId id) {
+    if (isRemoved(id)) {
+        return;
+    }
+    
+    const Symbol& symbol = m_symbols[id];
+    
+    auto mapIt = m_symbolMap.find(toLowerCase(symbol.name));
+    if (mapIt != m_symbolMap.end()) {
+        auto& ids = mapIt->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty()) {
+            m_symbolMap.erase(mapIt);
+        }
+    }
+    
+    // Blank the name in the arena so substring scans can never hit it; trie entries
+    // are skipped lazily and dropped on the next compaction
+    std::fill_n(m_nameArena.begin() + m_nameOffsets[id], symbol.name.length(), '\0');
+    
+    m_removed[id] = true;
+    m_removedCount++;
+}
+
+void AutocompleteEngine::compact() {
+    std::vector<Symbol> live;
+    live.reserve(m_symbols.size() - m_removedCount);
+    
+    for (SymbolId id = 0; id < m_symbols.size(); ++id) {
+        if (!isRemoved(id)) {
+            live.push_back(m_symbols[id]);
+        }
+    }
+    
+    clear();
+    for (const Symbol& symbol : live) {
+        insertSymbol(symbol);
+    }
+}
+
+SymbolId SymbolStore::append(const Symbol& symbol) {
+    if (m_size % CHUNK_SIZE == 0) {
+        m_chunks.push_back(std::make_unique<std::vector<Symbol>>());
+        m_chunks.back()->reserve(CHUNK_SIZE);
+    }
+    
+    m_chunks.back()->push_back(symbol);
+    return static_cast<SymbolId>(m_size++);
+}
+
+void SymbolStore::clear() {
+    m_chunks.clear();
+    m_size = 0;
 }
 
 std::vector<AutocompleteResult> AutocompleteEngine::getCompletions(const std::string& query, 
@@ -73,27 +330,107 @@ std::vector<AutocompleteResult> AutocompleteEngine::getCompletions(const std::st
         return {};
     }
     
-    std::vector<AutocompleteResult> results;
-    
-    // 1. Get prefix matches (highest priority)
-    auto prefixResults = getPrefixMatches(query, maxResults / 2);
-    for (auto& result : prefixResults) {
-        result.score *= m_prefixWeight;
-        results.push_back(result);
+    std::string lowerQuery = toLowerCase(query);
+    auto candidates = getCandidates(lowerQuery);
+    
+    size_t prefixLimit = maxResults / 2;
+    size_t acronymLimit = maxResults / 3;
+    size_t substringLimit = maxResults / 3;
+    size_t fuzzyLimit = maxResults / 2;
+    
+    // Per-partition heaps for each tier; only the survivors of the query are scored
+    size_t partitions = partitionCount(candidates->size());
+    std::vector<std::vector<AutocompleteResult>> prefixHeaps(partitions);
+    std::vector<std::vector<AutocompleteResult>> acronymHeaps(partitions);
+    std::vector<std::vector<AutocompleteResult>> substringHeaps(partitions);
+    std::vector<std::vector<AutocompleteResult>> fuzzyHeaps(partitions);
+    
+    // Queries that spell a name's leading initials resolve from the acronym index;
+    // its id lists are ascending, like the candidates
+    const std::vector<SymbolId>* initialsHits = nullptr;
+    auto initials = m_acronymIndex.find(lowerQuery);
+    if (initials != m_acronymIndex.end()) {
+        initialsHits = &initials->second;
     }
     
-    // 2. Get substring matches (medium priority)
-    auto substringResults = getSubstringMatches(query, maxResults / 3);
-    for (auto& result : substringResults) {
-        result.score *= m_substringWeight;
-        results.push_back(result);
-    }
+    forEachPartition(candidates->size(), partitions, [&](size_t part, size_t begin, size_t end) {
+        std::vector<uint8_t> failedStates;
+        for (size_t i = begin; i < end; ++i) {
+            SymbolId index = (*candidates)[i];
+            const Symbol& symbol = m_symbols[index];
+            std::string_view lowerName(m_nameArena.data() + m_nameOffsets[index], symbol.name.length());
+            
+            if (lowerName.compare(0, lowerQuery.size(), lowerQuery) == 0) {
+                double score = calculatePrefixScore(symbol.name.length(), query.length());
+                AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                        symbol.line, score, symbol.context, "prefix");
+                result.score = applyContextBoosts(score, symbol) * m_prefixWeight;
+                pushTopResult(prefixHeaps[part], std::move(result), prefixLimit);
+                continue;
+            }
+            
+            // "gSI" -> getSymbolIndex, "psi" -> parse_symbol_info; mixed runs such as
+            // "gsymidx" fall through to the word-start matcher
+            size_t wordsMatched = 0;
+            bool startsAtFirstWord = false;
+            bool acronym = false;
+            if (initialsHits && std::binary_search(initialsHits->begin(), initialsHits->end(), index)) {
+                wordsMatched = lowerQuery.size();
+                startsAtFirstWord = true;
+                acronym = true;
+            } else {
+                acronym = matchesWordStarts(index, lowerQuery, wordsMatched, startsAtFirstWord, failedStates);
+            }
+            if (acronym) {
+                size_t wordCount = m_wordStartOffsets[index + 1] - m_wordStartOffsets[index];
+                double score = calculateAcronymScore(wordsMatched, wordCount, startsAtFirstWord);
+                AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                        symbol.line, score, symbol.context, "acronym");
+                result.score = applyContextBoosts(score, symbol) * m_acronymWeight;
+                pushTopResult(acronymHeaps[part], std::move(result), acronymLimit);
+                continue;
+            }
+            
+            size_t pos = lowerName.find(lowerQuery);
+            if (pos != std::string_view::npos) {
+                double score = calculateSubstringScore(symbol.name.length(), pos, query.length());
+                AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                        symbol.line, score, symbol.context, "substring");
+                result.score = applyContextBoosts(score, symbol) * m_substringWeight;
+                pushTopResult(substringHeaps[part], std::move(result), substringLimit);
+                continue;
+            }
+            
+            double score = calculateFuzzyScore(symbol.name, query);
+            if (score >= m_fuzzyThreshold) {
+                AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                        symbol.line, score, symbol.context, "fuzzy");
+                result.score = applyContextBoosts(score, symbol) * m_fuzzyWeight;
+                pushTopResult(fuzzyHeaps[part], std::move(result), fuzzyLimit);
+            }
+        }
+    });
     
-    // 3. Get fuzzy matches (lower priority but more flexible)
-    auto fuzzyResults = getFuzzyMatches(query, maxResults / 2);
-    for (auto& result : fuzzyResults) {
-        result.score *= m_fuzzyWeight;
-        results.push_back(result);
+    std::vector<AutocompleteResult> results;
+    mergePartitions(prefixHeaps, prefixLimit, results);
+    mergePartitions(acronymHeaps, acronymLimit, results);
+    mergePartitions(substringHeaps, substringLimit, results);
+    mergePartitions(fuzzyHeaps, fuzzyLimit, results);
+    
+    // Typo-tolerant pass over the symbols that do not contain the query as a
+    // subsequence, only when the earlier tiers left room. A large index is
+    // sampled at a fixed stride of ids, so the same query always scores the
+    // same symbols whatever the thread count or machine load
+    if (results.size() < maxResults) {
+        size_t stride = (m_symbols.size() + TYPO_SCAN_LIMIT - 1) / TYPO_SCAN_LIMIT;
+        auto typoResults = collectPartitioned(fuzzyLimit, [&](size_t begin, size_t end, 
+                                                              std::vector<AutocompleteResult>& out) {
+            scanTypoRange(query, lowerQuery, begin, end, std::max<size_t>(stride, 1), fuzzyLimit, out);
+        });
+        for (auto& result : typoResults) {
+            result.score *= m_fuzzyWeight;
+            results.push_back(std::move(result));
+        }
     }
     
     // Remove duplicates and sort by score
@@ -103,6 +440,92 @@ std::vector<AutocompleteResult> AutocompleteEngine::getCompletions(const std::st
     return results;
 }
 
+std::shared_ptr<const std::vector<SymbolId>> AutocompleteEngine::getCandidates(
+    const std::string& lowerQuery) const {
+    std::shared_ptr<const std::vector<SymbolId>> base;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_queryCacheMutex);
+        
+        // Longest cached query that the new one extends; an exact hit covers backspace
+        auto best = m_queryCache.end();
+        for (auto it = m_queryCache.begin(); it != m_queryCache.end(); ++it) {
+            if (it->lowerQuery.size() <= lowerQuery.size() &&
+                lowerQuery.compare(0, it->lowerQuery.size(), it->lowerQuery) == 0 &&
+                (best == m_queryCache.end() || it->lowerQuery.size() > best->lowerQuery.size())) {
+                best = it;
+            }
+        }
+        
+        if (best != m_queryCache.end()) {
+            m_queryCache.splice(m_queryCache.begin(), m_queryCache, best);
+            if (best->lowerQuery.size() == lowerQuery.size()) {
+                m_queryCacheHits++;
+                return best->candidates;
+            }
+            base = best->candidates;
+        }
+    }
+    
+    // Survivors of "abc" are a superset of those of "abcd", so refine the cached
+    // set when there is one instead of rescanning every symbol
+    auto candidates = std::make_shared<std::vector<SymbolId>>();
+    size_t count = base ? base->size() : m_symbols.size();
+    size_t partitions = partitionCount(count);
+    std::vector<std::vector<SymbolId>> partials(partitions);
+    
+    forEachPartition(count, partitions, [&](size_t part, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            SymbolId index = base ? (*base)[i] : static_cast<SymbolId>(i);
+            if (isSubsequenceMatch(index, lowerQuery)) {
+                partials[part].push_back(index);
+            }
+        }
+    });
+    
+    for (const auto& partial : partials) {
+        candidates->insert(candidates->end(), partial.begin(), partial.end());
+    }
+    
+    if (base) {
+        m_queryCacheRefinements++;
+    } else {
+        m_queryCacheMisses++;
+    }
+    
+    if (m_queryCacheSize > 0) {
+        std::lock_guard<std::mutex> lock(m_queryCacheMutex);
+        m_queryCache.push_front({lowerQuery, candidates});
+        while (m_queryCache.size() > m_queryCacheSize) {
+            m_queryCache.pop_back();
+        }
+    }
+    
+    return candidates;
+}
+
+bool AutocompleteEngine::isSubsequenceMatch(SymbolId index, const std::string& lowerQuery) const {
+    if (isRemoved(index)) {
+        return false;
+    }
+    
+    const char* name = m_nameArena.data() + m_nameOffsets[index];
+    size_t length = m_symbols[index].name.length();
+    
+    size_t matched = 0;
+    for (size_t i = 0; i < length && matched < lowerQuery.size(); ++i) {
+        if (name[i] == lowerQuery[matched]) {
+            matched++;
+        }
+    }
+    return matched == lowerQuery.size();
+}
+
+void AutocompleteEngine::invalidateQueryCache() {
+    std::lock_guard<std::mutex> lock(m_queryCacheMutex);
+    m_queryCache.clear();
+}
+
 std::vector<AutocompleteResult> AutocompleteEngine::getPrefixMatches(const std::string& prefix, 
                                                                      size_t maxResults) const {
     std::vector<AutocompleteResult> results;
@@ -127,54 +550,290 @@ std::vector<AutocompleteResult> AutocompleteEngine::getPrefixMatches(const std::
 std::vector<AutocompleteResult> AutocompleteEngine::getFuzzyMatches(const std::string& query, 
                                                                     size_t maxResults, 
                                                                     double minScore) const {
+    return collectPartitioned(maxResults, [&](size_t begin, size_t end, 
+                                              std::vector<AutocompleteResult>& out) {
+        scanFuzzyRange(query, minScore, begin, end, maxResults, out);
+    });
+}
+
+std::vector<AutocompleteResult> AutocompleteEngine::getSubstringMatches(const std::string& substring, 
+                                                                        size_t maxResults) const {
+    std::string lowerSubstring = toLowerCase(substring);
+    
+    // The separator byte can never be part of a match
+    if (lowerSubstring.empty() || lowerSubstring.find('\0') != std::string::npos) {
+        return {};
+    }
+    
+    return collectPartitioned(maxResults, [&](size_t begin, size_t end, 
+                                              std::vector<AutocompleteResult>& out) {
+        scanSubstringRange(lowerSubstring, substring.length(), begin, end, maxResults, out);
+    });
+}
+
+std::vector<AutocompleteResult> AutocompleteEngine::getAcronymMatches(const std::string& acronym, 
+                                                                      size_t maxResults) const {
     std::vector<AutocompleteResult> results;
     
-    for (const Symbol& symbol : m_symbols) {
+    auto it = m_acronymIndex.find(toLowerCase(acronym));
+    if (it == m_acronymIndex.end()) {
+        return results;
+    }
+    
+    for (SymbolId id : it->second) {
+        if (isRemoved(id)) continue;
+        
+        const Symbol& symbol = m_symbols[id];
+        size_t wordCount = m_wordStartOffsets[id + 1] - m_wordStartOffsets[id];
+        double score = calculateAcronymScore(acronym.length(), wordCount, true);
+        AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                symbol.line, score, symbol.context, "acronym");
+        result.score = applyContextBoosts(score, symbol);
+        pushTopResult(results, std::move(result), maxResults);
+    }
+    
+    sortAndLimitResults(results, maxResults);
+    return results;
+}
+
+void AutocompleteEngine::scanFuzzyRange(const std::string& query, double minScore, size_t begin, 
+                                        size_t end, size_t maxResults, 
+                                        std::vector<AutocompleteResult>& out) const {
+    for (size_t i = begin; i < end; ++i) {
+        if (isRemoved(static_cast<SymbolId>(i))) continue;
+        
+        const Symbol& symbol = m_symbols[static_cast<SymbolId>(i)];
         double score = calculateFuzzyScore(symbol.name, query);
         
         if (score >= minScore) {
             AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
                                     symbol.line, score, symbol.context, "fuzzy");
             result.score = applyContextBoosts(score, symbol);
-            results.push_back(result);
+            pushTopResult(out, std::move(result), maxResults);
         }
     }
-    
-    sortAndLimitResults(results, maxResults);
-    return results;
 }
 
-std::vector<AutocompleteResult> AutocompleteEngine::getSubstringMatches(const std::string& substring, 
-                                                                        size_t maxResults) const {
-    std::vector<AutocompleteResult> results;
-    std::string lowerSubstring = toLowerCase(substring);
-    
-    for (const Symbol& symbol : m_symbols) {
-        std::string lowerSymbol = toLowerCase(symbol.name);
+void AutocompleteEngine::scanTypoRange(const std::string& query, const std::string& lowerQuery, 
+                                       size_t begin, size_t end, size_t stride, size_t maxResults, 
+                                       std::vector<AutocompleteResult>& out) const {
+    // Visit the multiples of stride, which do not depend on the partitioning
+    for (size_t i = (begin + stride - 1) / stride * stride; i < end; i += stride) {
+        // Subsequence matches were already scored by the candidate pass
+        SymbolId id = static_cast<SymbolId>(i);
+        if (isRemoved(id) || isSubsequenceMatch(id, lowerQuery)) continue;
         
-        if (lowerSymbol.find(lowerSubstring) != std::string::npos) {
-            double score = calculateBaseScore(symbol.name, substring, "substring");
+        const Symbol& symbol = m_symbols[id];
+        double score = calculateFuzzyScore(symbol.name, query);
+        
+        if (score >= m_fuzzyThreshold) {
             AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
-                                    symbol.line, score, symbol.context, "substring");
+                                    symbol.line, score, symbol.context, "fuzzy");
             result.score = applyContextBoosts(score, symbol);
-            results.push_back(result);
+            pushTopResult(out, std::move(result), maxResults);
         }
     }
+}
+
+void AutocompleteEngine::scanSubstringRange(const std::string& lowerSubstring, size_t queryLength, 
+                                            size_t begin, size_t end, size_t maxResults, 
+                                            std::vector<AutocompleteResult>& out) const {
+    if (begin >= end) {
+        return;
+    }
     
-    sortAndLimitResults(results, maxResults);
+    SubstringFinder find = substringKernel().find;
+    const char* arena = m_nameArena.data();
+    size_t offset = m_nameOffsets[begin];
+    size_t rangeEnd = end < m_nameOffsets.size() ? m_nameOffsets[end] : m_nameArena.size();
+    
+    while (offset < rangeEnd) {
+        size_t hit = find(arena + offset, rangeEnd - offset, 
+                          lowerSubstring.data(), lowerSubstring.size());
+        if (hit == std::string::npos) {
+            break;
+        }
+        
+        size_t absolute = offset + hit;
+        size_t index = symbolIndexForOffset(absolute);
+        const Symbol& symbol = m_symbols[static_cast<SymbolId>(index)];
+        
+        double score = calculateSubstringScore(symbol.name.length(), 
+                                               absolute - m_nameOffsets[index], queryLength);
+        AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                symbol.line, score, symbol.context, "substring");
+        result.score = applyContextBoosts(score, symbol);
+        pushTopResult(out, std::move(result), maxResults);
+        
+        // Report each symbol once: resume after its separator
+        offset = m_nameOffsets[index] + symbol.name.length() + 1;
+    }
+}
+
+std::vector<AutocompleteResult> AutocompleteEngine::collectPartitioned(size_t maxResults, 
+    const std::function<void(size_t, size_t, std::vector<AutocompleteResult>&)>& scan) const {
+    std::vector<AutocompleteResult> results;
+    size_t symbolCount = m_symbols.size();
+    
+    if (maxResults == 0 || symbolCount == 0) {
+        return results;
+    }
+    
+    size_t partitions = partitionCount(symbolCount);
+    std::vector<std::vector<AutocompleteResult>> partials(partitions);
+    
+    // Each partition keeps its own top-K; they are merged once at the end
+    forEachPartition(symbolCount, partitions, [&](size_t part, size_t begin, size_t end) {
+        scan(begin, end, partials[part]);
+    });
+    
+    mergePartitions(partials, maxResults, results);
     return results;
 }
 
-void AutocompleteEngine::insertIntoTrie(const std::string& word, const Symbol* symbol) {
+void AutocompleteEngine::mergePartitions(std::vector<std::vector<AutocompleteResult>>& partials, 
+                                         size_t maxResults, 
+                                         std::vector<AutocompleteResult>& out) const {
+    std::vector<AutocompleteResult> merged;
+    for (auto& partial : partials) {
+        merged.insert(merged.end(), std::make_move_iterator(partial.begin()), 
+                      std::make_move_iterator(partial.end()));
+    }
+    
+    sortAndLimitResults(merged, maxResults);
+    out.insert(out.end(), std::make_move_iterator(merged.begin()), 
+               std::make_move_iterator(merged.end()));
+}
+
+size_t AutocompleteEngine::partitionCount(size_t itemCount) const {
+    // One partition per worker plus one for the calling thread
+    if (!m_threadPool || itemCount < m_parallelThreshold) {
+        return 1;
+    }
+    return m_threadPool->getThreadCount() + 1;
+}
+
+void AutocompleteEngine::forEachPartition(size_t itemCount, size_t partitions, 
+    const std::function<void(size_t, size_t, size_t)>& scan) const {
+    if (partitions <= 1) {
+        scan(0, 0, itemCount);
+        return;
+    }
+    
+    size_t chunkSize = (itemCount + partitions - 1) / partitions;
+    m_threadPool->parallelFor(partitions, [&](size_t part) {
+        size_t begin = std::min(part * chunkSize, itemCount);
+        size_t end = std::min(begin + chunkSize, itemCount);
+        scan(part, begin, end);
+    });
+}
+
+void AutocompleteEngine::indexWordStarts(const std::string& name, SymbolId id) {
+    std::vector<size_t> starts = AutocompleteUtils::getWordStarts(name);
+    std::string initials;
+    
+    for (size_t start : starts) {
+        if (start > UINT16_MAX) break;
+        m_wordStarts.push_back(static_cast<uint16_t>(start));
+        initials += static_cast<char>(std::tolower(static_cast<unsigned char>(name[start])));
+    }
+    m_wordStartOffsets.push_back(static_cast<uint32_t>(m_wordStarts.size()));
+    
+    // Index every initials prefix of two or more letters, so both "gs" and "gsi"
+    // resolve getSymbolIndex with a single hash lookup
+    const size_t maxAcronymLength = 8;
+    for (size_t length = 2; length <= std::min(initials.size(), maxAcronymLength); ++length) {
+        m_acronymIndex[initials.substr(0, length)].push_back(id);
+    }
+}
+
+bool AutocompleteEngine::matchesWordStarts(SymbolId id, const std::string& lowerQuery, 
+                                           size_t& wordsMatched, bool& startsAtFirstWord, 
+                                           std::vector<uint8_t>& failed) const {
+    size_t wordCount = m_wordStartOffsets[id + 1] - m_wordStartOffsets[id];
+    if (wordCount < 2 || lowerQuery.size() < 2) {
+        return false;
+    }
+    
+    const char* name = m_nameArena.data() + m_nameOffsets[id];
+    const uint16_t* starts = m_wordStarts.data() + m_wordStartOffsets[id];
+    size_t nameLength = m_symbols[id].name.length();
+    
+    // Whether (queryPos, word) can finish depends on nothing else, so a state that
+    // failed once fails everywhere; this keeps "a_a_a_..." names polynomial
+    failed.assign((lowerQuery.size() + 1) * (wordCount + 1), 0);
+    
+    for (size_t word = 0; word < wordCount; ++word) {
+        wordsMatched = 0;
+        if (matchWordsFrom(name, starts, wordCount, nameLength, lowerQuery, 0, word, wordsMatched, 
+                           failed.data())) {
+            startsAtFirstWord = word == 0;
+            // A match inside a single word is a prefix or substring hit, not an acronym
+            return wordsMatched >= 2;
+        }
+    }
+    return false;
+}
+
+bool AutocompleteEngine::matchWordsFrom(const char* name, const uint16_t* starts, size_t wordCount, 
+                                        size_t nameLength, const std::string& lowerQuery, 
+                                        size_t queryPos, size_t word, size_t& wordsMatched, 
+                                        uint8_t* failed) const {
+    if (queryPos == lowerQuery.size()) {
+        return true;
+    }
+    
+    uint8_t& dead = failed[queryPos * (wordCount + 1) + word];
+    if (dead) {
+        return false;
+    }
+    
+    // Each step consumes a run of query characters from the start of some later word
+    for (size_t w = word; w < wordCount; ++w) {
+        size_t start = starts[w];
+        size_t wordEnd = w + 1 < wordCount ? starts[w + 1] : nameLength;
+        
+        size_t run = 0;
+        while (queryPos + run < lowerQuery.size() && start + run < wordEnd &&
+               name[start + run] == lowerQuery[queryPos + run]) {
+            run++;
+        }
+        
+        // Prefer consuming as much of the word as possible, then back off
+        for (size_t taken = run; taken > 0; --taken) {
+            if (matchWordsFrom(name, starts, wordCount, nameLength, lowerQuery, 
+                               queryPos + taken, w + 1, wordsMatched, failed)) {
+                wordsMatched++;
+                return true;
+            }
+        }
+    }
+    dead = 1;
+    return false;
+}
+
+void AutocompleteEngine::appendToArena(const std::string& lowerName) {
+    m_nameOffsets.push_back(static_cast<uint32_t>(m_nameArena.size()));
+    m_nameArena += lowerName;
+    m_nameArena += '\0';
+}
+
+size_t AutocompleteEngine::symbolIndexForOffset(size_t offset) const {
+    auto it = std::upper_bound(m_nameOffsets.begin(), m_nameOffsets.end(), 
+                               static_cast<uint32_t>(offset));
+    return static_cast<size_t>(it - m_nameOffsets.begin()) - 1;
+}
+
+void AutocompleteEngine::insertIntoTrie(const std::string& lowerWord, SymbolId id) {
     TrieNode* current = m_trieRoot.get();
-    std::string lowerWord = toLowerCase(word);
     
     for (char c : lowerWord) {
-        if (current->children.find(c) == current->children.end()) {
-            current->children[c] = std::make_unique<TrieNode>();
+        auto& child = current->children[c];
+        if (!child) {
+            child = std::make_unique<TrieNode>();
         }
-        current = current->children[c].get();
-        current->symbols.push_back(symbol);
+        current = child.get();
+        current->symbols.push_back(id);
     }
     
     current->isEndOfWord = true;
@@ -183,26 +842,18 @@ void AutocompleteEngine::insertIntoTrie(const std::string& word, const Symbol* s
 void AutocompleteEngine::collectTrieMatches(TrieNode* node, const std::string& prefix, 
                                            std::vector<AutocompleteResult>& results, 
                                            size_t maxResults) const {
-    if (results.size() >= maxResults) {
-        return;
-    }
-    
-    // Add symbols at this node
-    for (const Symbol* symbol : node->symbols) {
+    // Every node already lists all symbols below it, so no need to descend
+    for (SymbolId id : node->symbols) {
         if (results.size() >= maxResults) break;
+        if (isRemoved(id)) continue;
         
-        double score = calculateBaseScore(symbol->name, prefix, "prefix");
-        AutocompleteResult result(symbol->name, symbol->type, symbol->file, 
-                                symbol->line, score, symbol->context, "prefix");
-        result.score = applyContextBoosts(score, *symbol);
+        const Symbol& symbol = m_symbols[id];
+        double score = calculateBaseScore(symbol.name, prefix, "prefix");
+        AutocompleteResult result(symbol.name, symbol.type, symbol.file, 
+                                symbol.line, score, symbol.context, "prefix");
+        result.score = applyContextBoosts(score, symbol);
         results.push_back(result);
     }
-    
-    // Recursively collect from children
-    for (const auto& [ch, child] : node->children) {
-        if (results.size() >= maxResults) break;
-        collectTrieMatches(child.get(), prefix, results, maxResults);
-    }
 }
 
 double AutocompleteEngine::calculateFuzzyScore(const std::string& target, const std::string& query) const {
@@ -343,21 +994,40 @@ double AutocompleteEngine::calculateBaseScore(const std::string& symbol, const s
     if (matchType == "prefix") {
         // Exact prefix gets highest score
         if (lowerSymbol.substr(0, lowerQuery.length()) == lowerQuery) {
-            return 1.0 - (static_cast<double>(symbol.length() - query.length()) / symbol.length() * 0.1);
+            return calculatePrefixScore(symbol.length(), query.length());
         }
     } else if (matchType == "substring") {
         size_t pos = lowerSymbol.find(lowerQuery);
         if (pos != std::string::npos) {
-            // Earlier position gets higher score
-            double positionBonus = 1.0 - (static_cast<double>(pos) / symbol.length() * 0.3);
-            double lengthRatio = static_cast<double>(query.length()) / symbol.length();
-            return positionBonus * lengthRatio;
+            return calculateSubstringScore(symbol.length(), pos, query.length());
         }
     }
     
     return 0.5; // Default score
 }
 
+double AutocompleteEngine::calculatePrefixScore(size_t symbolLength, size_t queryLength) const {
+    // Exact prefix gets highest score, shorter remainders rank higher
+    return 1.0 - (static_cast<double>(symbolLength - queryLength) / symbolLength * 0.1);
+}
+
+double AutocompleteEngine::calculateAcronymScore(size_t wordsMatched, size_t wordCount, 
+                                                 bool startsAtFirstWord) const {
+    // Covering more of the symbol's words ranks higher; acronyms anchored
+    // at the first word are what users usually mean
+    double coverage = static_cast<double>(std::min(wordsMatched, wordCount)) / wordCount;
+    double score = 0.6 + 0.4 * coverage;
+    return startsAtFirstWord ? score : score * 0.8;
+}
+
+double AutocompleteEngine::calculateSubstringScore(size_t symbolLength, size_t matchPos, 
+                                                   size_t queryLength) const {
+    // Earlier position gets higher score
+    double positionBonus = 1.0 - (static_cast<double>(matchPos) / symbolLength * 0.3);
+    double lengthRatio = static_cast<double>(queryLength) / symbolLength;
+    return positionBonus * lengthRatio;
+}
+
 double AutocompleteEngine::applyContextBoosts(double baseScore, const Symbol& symbol) const {
     double score = baseScore;
     
@@ -423,9 +1093,23 @@ void AutocompleteEngine::sortAndLimitResults(std::vector<AutocompleteResult>& re
     }
 }
 
+void AutocompleteEngine::pushTopResult(std::vector<AutocompleteResult>& heap, 
+                                       AutocompleteResult&& result, size_t maxResults) const {
+    // Min-heap on score: the weakest kept result sits at the front
+    if (heap.size() < maxResults) {
+        heap.push_back(std::move(result));
+        std::push_heap(heap.begin(), heap.end(), std::greater<AutocompleteResult>());
+    } else if (maxResults > 0 && result.score > heap.front().score) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<AutocompleteResult>());
+        heap.back() = std::move(result);
+        std::push_heap(heap.begin(), heap.end(), std::greater<AutocompleteResult>());
+    }
+}
+
 std::string AutocompleteEngine::toLowerCase(const std::string& str) const {
     std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+    std::transform(result.begin(), result.end(), result.begin(), 
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
     return result;
 }
 
@@ -484,7 +1168,7 @@ void AutocompleteEngine::printResult(const AutocompleteResult& result, size_t in
 }
 
 size_t AutocompleteEngine::getSymbolCount() const {
-    return m_symbols.size();
+    return m_symbols.size() - m_removedCount;
 }
 
 size_t AutocompleteEngine::getTrieSize() const {
@@ -506,8 +1190,17 @@ void AutocompleteEngine::printStatistics() const {
     std::cout << "│ 📊 Total Symbols: " << getSymbolCount() << "\n";
     std::cout << "│ 🌳 Trie Nodes: " << getTrieSize() << "\n";
     std::cout << "│ 🗂️  Unique Names: " << m_symbolMap.size() << "\n";
+    std::cout << "│ 🧵 Name Arena: " << m_nameArena.size() << " bytes (" 
+              << substringKernel().name << " substring scan)\n";
+    std::cout << "│ 🧮 Scoring Threads: " 
+              << (m_threadPool ? m_threadPool->getThreadCount() + 1 : 1) 
+              << " (parallel above " << m_parallelThreshold << " symbols)\n";
+    std::cout << "│ ♻️  Query Cache: " << m_queryCacheHits << " hits, " 
+              << m_queryCacheRefinements << " refinements, " << m_queryCacheMisses << " full scans\n";
     std::cout << "│ ⚙️  Fuzzy Threshold: " << m_fuzzyThreshold << "\n";
+    std::cout << "│ 🔠 Acronym Keys: " << m_acronymIndex.size() << "\n";
     std::cout << "│ 🎯 Prefix Weight: " << m_prefixWeight << "\n";
+    std::cout << "│ 🐫 Acronym Weight: " << m_acronymWeight << "\n";
     std::cout << "│ 🔍 Fuzzy Weight: " << m_fuzzyWeight << "\n";
     std::cout << "│ 📝 Substring Weight: " << m_substringWeight << "\n";
     std::cout << "└────────────────────────────────────────────────────────────────────────────┘\n";
@@ -517,6 +1210,38 @@ void AutocompleteEngine::setPerformanceLogger(PerformanceLogger* logger) {
     m_logger = logger;
 }
 
+void AutocompleteEngine::setThreadCount(size_t threadCount) {
+    m_threadCount = threadCount;
+    
+    m_threadPool.reset();
+    ensureThreadPool();
+}
+
+void AutocompleteEngine::setParallelThreshold(size_t minSymbols) {
+    m_parallelThreshold = minSymbols;
+    ensureThreadPool();
+}
+
+void AutocompleteEngine::ensureThreadPool() {
+    // The pool is created once the index is large enough and then reused by every query
+    if (!m_threadPool && m_threadCount != 1 && m_symbols.size() >= m_parallelThreshold) {
+        m_threadPool = std::make_unique<ThreadPool>(m_threadCount);
+    }
+}
+
+void AutocompleteEngine::setVerbose(bool verbose) {
+    m_verbose = verbose;
+}
+
+void AutocompleteEngine::setQueryCacheSize(size_t entries) {
+    m_queryCacheSize = entries;
+    
+    std::lock_guard<std::mutex> lock(m_queryCacheMutex);
+    while (m_queryCache.size() > m_queryCacheSize) {
+        m_queryCache.pop_back();
+    }
+}
+
 void AutocompleteEngine::setFuzzyThreshold(double threshold) {
     m_fuzzyThreshold = threshold;
 }
@@ -525,6 +1250,10 @@ void AutocompleteEngine::setPrefixWeight(double weight) {
     m_prefixWeight = weight;
 }
 
+void AutocompleteEngine::setAcronymWeight(double weight) {
+    m_acronymWeight = weight;
+}
+
 void AutocompleteEngine::setFuzzyWeight(double weight) {
     m_fuzzyWeight = weight;
 }
@@ -569,20 +1298,47 @@ std::string AutocompleteUtils::getFileBasename(const std::string& filePath) {
 
 std::vector<std::string> AutocompleteUtils::expandCamelCase(const std::string& str) {
     std::vector<std::string> parts;
-    std::string current;
+    std::vector<size_t> starts = getWordStarts(str);
     
-    for (char c : str) {
-        if (std::isupper(c) && !current.empty()) {
-            parts.push_back(current);
-            current = c;
-        } else {
-            current += c;
+    for (size_t i = 0; i < starts.size(); ++i) {
+        size_t end = i + 1 < starts.size() ? starts[i + 1] : str.length();
+        
+        // Drop the separators (_ - . etc.) between words
+        size_t wordEnd = starts[i];
+        while (wordEnd < end && std::isalnum(static_cast<unsigned char>(str[wordEnd]))) {
+            wordEnd++;
         }
+        parts.push_back(str.substr(starts[i], wordEnd - starts[i]));
     }
     
-    if (!current.empty()) {
-        parts.push_back(current);
+    return parts;
+}
+
+std::vector<size_t> AutocompleteUtils::getWordStarts(const std::string& str) {
+    std::vector<size_t> starts;
+    
+    for (size_t i = 0; i < str.length(); ++i) {
+        unsigned char c = static_cast<unsigned char>(str[i]);
+        if (!std::isalnum(c)) {
+            continue;
+        }
+        
+        if (i == 0) {
+            starts.push_back(i);
+            continue;
+        }
+        
+        unsigned char prev = static_cast<unsigned char>(str[i - 1]);
+        bool afterSeparator = !std::isalnum(prev);
+        bool lowerToUpper = std::isupper(c) && std::islower(prev);
+        // Last capital of an acronym run starts a new word: HTTPServer -> HTTP, Server
+        bool acronymEnd = std::isupper(c) && std::isupper(prev) && i + 1 < str.length() &&
+                          std::islower(static_cast<unsigned char>(str[i + 1]));
+        
+        if (afterSeparator || lowerToUpper || acronymEnd) {
+            starts.push_back(i);
+        }
     }
     
-    return parts;
-} 
\ No newline at end of file
+    return starts;
+}
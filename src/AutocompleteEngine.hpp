@@ -7,7 +7,13 @@
 #include <unordered_map>
 #include <algorithm>
 #include <set>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <atomic>
 #include "Symbol.hpp"
+#include "ThreadPool.hpp"
 
 // Forward declarations
 class PerformanceLogger;
@@ -19,7 +25,7 @@ struct AutocompleteResult {
     int line;
     double score;
     std::string context;
-    std::string matchType; // "prefix", "fuzzy", "substring"
+    std::string matchType; // "prefix", "acronym", "fuzzy", "substring"
     
     // Default constructor
     AutocompleteResult() 
@@ -35,10 +41,35 @@ struct AutocompleteResult {
     }
 };
 
+// Stable handle for a symbol owned by the engine
+using SymbolId = uint32_t;
+
+// Append-only symbol storage split into fixed-size chunks. Chunks never move once
+// allocated, so a SymbolId and any reference to its Symbol stay valid as the store grows.
+class SymbolStore {
+public:
+    static constexpr size_t CHUNK_SIZE = 4096;
+    
+    SymbolId append(const Symbol& symbol);
+    void clear();
+    
+    const Symbol& operator[](SymbolId id) const {
+        return (*m_chunks[id / CHUNK_SIZE])[id % CHUNK_SIZE];
+    }
+    Symbol& operator[](SymbolId id) {
+        return (*m_chunks[id / CHUNK_SIZE])[id % CHUNK_SIZE];
+    }
+    size_t size() const { return m_size; }
+    
+private:
+    std::vector<std::unique_ptr<std::vector<Symbol>>> m_chunks;
+    size_t m_size = 0;
+};
+
 // Trie node for efficient prefix matching
 struct TrieNode {
     std::unordered_map<char, std::unique_ptr<TrieNode>> children;
-    std::vector<const Symbol*> symbols; // Symbols ending at this node
+    std::vector<SymbolId> symbols; // Symbols whose name passes through this node
     bool isEndOfWord;
     
     TrieNode() : isEndOfWord(false) {}
@@ -47,11 +78,14 @@ struct TrieNode {
 class AutocompleteEngine {
 public:
     AutocompleteEngine();
-    ~AutocompleteEngine() = default;
+    ~AutocompleteEngine();
     
     // Index management
     void buildIndex(const std::vector<Symbol>& symbols);
     void addSymbol(const Symbol& symbol);
+    size_t removeFile(const std::string& filePath);
+    void updateFile(const std::string& filePath, const std::vector<Symbol>& symbols);
+    size_t renameFile(const std::string& oldPath, const std::string& newPath);
     void clear();
     
     // Core autocomplete functionality
@@ -66,15 +100,29 @@ public:
                                                     double minScore = 0.3) const;
     std::vector<AutocompleteResult> getSubstringMatches(const std::string& substring, 
                                                         size_t maxResults = 10) const;
+    std::vector<AutocompleteResult> getAcronymMatches(const std::string& acronym, 
+                                                      size_t maxResults = 10) const;
     
     // Configuration
     void setFuzzyThreshold(double threshold);
     void setPrefixWeight(double weight);
+    void setAcronymWeight(double weight);
     void setFuzzyWeight(double weight);
     void setSubstringWeight(double weight);
     void setTypeBoosts(const std::unordered_map<SymbolType, double>& boosts);
     void setPerformanceLogger(PerformanceLogger* logger);
     
+    // Parallel scoring: indexes with at least `minSymbols` symbols are split across
+    // a persistent pool of `threadCount` workers (0 = one per hardware thread)
+    void setThreadCount(size_t threadCount);
+    void setParallelThreshold(size_t minSymbols);
+    
+    // Number of recent query states kept for keystroke refinement (0 disables caching)
+    void setQueryCacheSize(size_t entries);
+    
+    // Print a summary line after buildIndex (off where stdout carries a protocol)
+    void setVerbose(bool verbose);
+    
     // Statistics
     size_t getSymbolCount() const;
     size_t getTrieSize() const;
@@ -87,27 +135,109 @@ private:
     // Trie for prefix matching
     std::unique_ptr<TrieNode> m_trieRoot;
     
-    // Symbol storage
-    std::vector<Symbol> m_symbols;
-    std::unordered_map<std::string, std::vector<size_t>> m_symbolMap; // name -> indices
+    // Symbol storage. Removed symbols are tombstoned and reclaimed by compaction
+    // once they make up most of the store.
+    SymbolStore m_symbols;
+    std::vector<bool> m_removed;
+    size_t m_removedCount;
+    std::unordered_map<std::string, std::vector<SymbolId>> m_symbolMap; // name -> ids
+    std::unordered_map<std::string, std::vector<SymbolId>> m_fileSymbols; // file -> ids
+    
+    // Word boundaries for camelCase / snake_case matching. Word start positions of
+    // symbol id live in m_wordStarts[m_wordStartOffsets[id] .. m_wordStartOffsets[id + 1]).
+    std::vector<uint16_t> m_wordStarts;
+    std::vector<uint32_t> m_wordStartOffsets;
+    std::unordered_map<std::string, std::vector<SymbolId>> m_acronymIndex; // initials prefix -> ids
+    
+    // Lowercased names packed back to back, each followed by a separator byte,
+    // so substring search is a single linear scan instead of one allocation per symbol
+    std::string m_nameArena;
+    std::vector<uint32_t> m_nameOffsets; // symbol id -> start offset in m_nameArena
     
     // Configuration
     double m_fuzzyThreshold;
     double m_prefixWeight;
+    double m_acronymWeight;
     double m_fuzzyWeight;
     double m_substringWeight;
     std::unordered_map<SymbolType, double> m_typeBoosts;
     
     // Performance
     PerformanceLogger* m_logger;
+    bool m_verbose;
+    
+    // Parallel scoring
+    size_t m_threadCount;
+    size_t m_parallelThreshold;
+    std::unique_ptr<ThreadPool> m_threadPool;
+    
+    // Most symbols the typo-tolerant pass scores per query; larger indexes are
+    // sampled at an even stride
+    static constexpr size_t TYPO_SCAN_LIMIT = 50000;
+    
+    // Keystroke refinement cache: candidate set of recent queries, most recent first.
+    // A query's candidates are the symbols containing it as a subsequence, which covers
+    // its prefix and substring matches and shrinks monotonically as the query grows.
+    struct QueryState {
+        std::string lowerQuery;
+        std::shared_ptr<const std::vector<SymbolId>> candidates;
+    };
+    size_t m_queryCacheSize;
+    mutable std::list<QueryState> m_queryCache;
+    mutable std::mutex m_queryCacheMutex;
+    mutable std::atomic<size_t> m_queryCacheHits;
+    mutable std::atomic<size_t> m_queryCacheRefinements;
+    mutable std::atomic<size_t> m_queryCacheMisses;
+    
+    // Symbol lifecycle
+    SymbolId insertSymbol(const Symbol& symbol);
+    void removeSymbol(SymbolId id);
+    bool isRemoved(SymbolId id) const { return m_removed[id]; }
+    void compact();
     
     // Trie operations
-    void insertIntoTrie(const std::string& word, const Symbol* symbol);
+    void insertIntoTrie(const std::string& lowerWord, SymbolId id);
     void collectTrieMatches(TrieNode* node, const std::string& prefix, 
                            std::vector<AutocompleteResult>& results, 
                            size_t maxResults) const;
     size_t calculateTrieSize(TrieNode* node) const;
     
+    // Acronym index operations
+    void indexWordStarts(const std::string& name, SymbolId id);
+    // `failed` is caller-owned scratch memoizing dead (queryPos, word) states
+    bool matchesWordStarts(SymbolId id, const std::string& lowerQuery, size_t& wordsMatched, 
+                           bool& startsAtFirstWord, std::vector<uint8_t>& failed) const;
+    bool matchWordsFrom(const char* name, const uint16_t* starts, size_t wordCount, 
+                        size_t nameLength, const std::string& lowerQuery, size_t queryPos, 
+                        size_t word, size_t& wordsMatched, uint8_t* failed) const;
+    
+    // Name arena operations
+    void appendToArena(const std::string& lowerName);
+    size_t symbolIndexForOffset(size_t offset) const;
+    
+    // Range scans used by the fuzzy and substring tiers; each fills `out` with
+    // the best `maxResults` matches among symbols [begin, end)
+    void scanFuzzyRange(const std::string& query, double minScore, size_t begin, size_t end, 
+                        size_t maxResults, std::vector<AutocompleteResult>& out) const;
+    void scanTypoRange(const std::string& query, const std::string& lowerQuery, size_t begin, 
+                       size_t end, size_t stride, size_t maxResults, 
+                       std::vector<AutocompleteResult>& out) const;
+    void scanSubstringRange(const std::string& lowerSubstring, size_t queryLength, size_t begin, 
+                            size_t end, size_t maxResults, std::vector<AutocompleteResult>& out) const;
+    void ensureThreadPool();
+    size_t partitionCount(size_t itemCount) const;
+    void forEachPartition(size_t itemCount, size_t partitions, 
+                          const std::function<void(size_t, size_t, size_t)>& scan) const;
+    std::vector<AutocompleteResult> collectPartitioned(size_t maxResults, 
+        const std::function<void(size_t, size_t, std::vector<AutocompleteResult>&)>& scan) const;
+    void mergePartitions(std::vector<std::vector<AutocompleteResult>>& partials, size_t maxResults, 
+                         std::vector<AutocompleteResult>& out) const;
+    
+    // Query refinement cache
+    std::shared_ptr<const std::vector<SymbolId>> getCandidates(const std::string& lowerQuery) const;
+    bool isSubsequenceMatch(SymbolId index, const std::string& lowerQuery) const;
+    void invalidateQueryCache();
+    
     // Fuzzy matching algorithms
     double calculateFuzzyScore(const std::string& target, const std::string& query) const;
     double calculateLevenshteinScore(const std::string& s1, const std::string& s2) const;
@@ -117,6 +247,9 @@ private:
     // Scoring and ranking
     double calculateBaseScore(const std::string& symbol, const std::string& query, 
                              const std::string& matchType) const;
+    double calculatePrefixScore(size_t symbolLength, size_t queryLength) const;
+    double calculateAcronymScore(size_t wordsMatched, size_t wordCount, bool startsAtFirstWord) const;
+    double calculateSubstringScore(size_t symbolLength, size_t matchPos, size_t queryLength) const;
     double applyContextBoosts(double baseScore, const Symbol& symbol) const;
     double applyTypeBoost(double score, SymbolType type) const;
     double applyFrequencyBoost(double score, const std::string& symbolName) const;
@@ -130,6 +263,8 @@ private:
     // Result processing
     void deduplicateResults(std::vector<AutocompleteResult>& results) const;
     void sortAndLimitResults(std::vector<AutocompleteResult>& results, size_t maxResults) const;
+    void pushTopResult(std::vector<AutocompleteResult>& heap, AutocompleteResult&& result, 
+                       size_t maxResults) const;
     
     // Interactive helpers
     void printResult(const AutocompleteResult& result, size_t index) const;
@@ -141,6 +276,7 @@ class AutocompleteUtils {
 public:
     static std::string getCommonPrefix(const std::vector<std::string>& strings);
     static std::vector<std::string> expandCamelCase(const std::string& str);
+    static std::vector<size_t> getWordStarts(const std::string& str);
     static double calculateRelevanceScore(const AutocompleteResult& result, 
                                          const std::string& query);
     static std::string formatSymbolSignature(const Symbol& symbol);
@@ -0,0 +1,58 @@
+#ifndef BINARYFORMAT_HPP
+#define BINARYFORMAT_HPP
+
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+// Helpers for the little on-disk formats under the cache directory. Values
+// are written in native byte order: the files never leave the machine.
+
+template <typename T>
+void putValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void putString(std::string& out, const std::string& value) {
+    putValue<uint32_t>(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+// Bounds-checked reader over a record payload
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size) : m_data(data), m_size(size), m_offset(0), m_ok(true) {}
+
+    template <typename T>
+    T value() {
+        T result{};
+        if (m_offset + sizeof(T) > m_size) {
+            m_ok = false;
+            return result;
+        }
+        std::memcpy(&result, m_data + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return result;
+    }
+
+    std::string string() {
+        uint32_t length = value<uint32_t>();
+        if (!m_ok || m_offset + length > m_size) {
+            m_ok = false;
+            return "";
+        }
+        std::string result(m_data + m_offset, length);
+        m_offset += length;
+        return result;
+    }
+
+    bool ok() const { return m_ok; }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_offset;
+    bool m_ok;
+};
+
+#endif // BINARYFORMAT_HPP
@@ -0,0 +1,26 @@
+#ifndef CANCELLATIONTOKEN_HPP
+#define CANCELLATIONTOKEN_HPP
+
+#include <atomic>
+
+// Set by one thread, polled by another. Long loops check it every few
+// thousand iterations and bail out early; the caller decides what a
+// cancelled result means.
+class CancellationToken {
+public:
+    CancellationToken() : m_cancelled(false) {}
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    // Null tokens are never cancelled
+    static bool isCancelled(const CancellationToken* token) { return token && token->isCancelled(); }
+
+private:
+    std::atomic<bool> m_cancelled;
+};
+
+#endif // CANCELLATIONTOKEN_HPP
@@ -0,0 +1,186 @@
+#include "DaemonClient.hpp"
+#include "NavixDaemon.hpp"
+#include <thread>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifndef _WIN32
+bool sendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+#ifdef _WIN32
+
+bool DaemonClient::isRunning(const std::string& rootPath) {
+    return false;
+}
+
+bool DaemonClient::search(const std::string& rootPath, const std::string& query, bool fuzzy,
+                          std::vector<Symbol>& results) {
+    return false;
+}
+
+bool DaemonClient::proxyLSP(const std::string& rootPath) {
+    return false;
+}
+
+int DaemonClient::connectTo(const std::string& rootPath) {
+    return -1;
+}
+
+#else
+
+bool DaemonClient::isRunning(const std::string& rootPath) {
+    int fd = connectTo(rootPath);
+    if (fd < 0) {
+        return false;
+    }
+    ::close(fd);
+    return true;
+}
+
+bool DaemonClient::search(const std::string& rootPath, const std::string& query, bool fuzzy,
+                          std::vector<Symbol>& results) {
+    int fd = connectTo(rootPath);
+    if (fd < 0) {
+        return false;
+    }
+
+    std::string request = std::string(fuzzy ? "search " : "search-exact ") + query + "\n";
+    std::string response;
+    if (sendAll(fd, request.data(), request.size())) {
+        char buffer[64 * 1024];
+        ssize_t n;
+        while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+    ::close(fd);
+
+    if (response.compare(0, 6, "error ") == 0) {
+        return false;
+    }
+
+    // <type>\t<line>\t<file>\t<name>\t<context>
+    results.clear();
+    std::istringstream lines(response);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::string fields[5];
+        size_t start = 0;
+        for (int i = 0; i < 5; i++) {
+            size_t tab = i < 4 ? line.find('\t', start) : std::string::npos;
+            fields[i] = line.substr(start, tab == std::string::npos ? std::string::npos : tab - start);
+            if (tab == std::string::npos) {
+                break;
+            }
+            start = tab + 1;
+        }
+        if (fields[2].empty()) {
+            continue;
+        }
+        results.emplace_back(fields[3], static_cast<SymbolType>(std::atoi(fields[0].c_str())), fields[2],
+                             std::atoi(fields[1].c_str()), fields[4]);
+    }
+    return true;
+}
+
+bool DaemonClient::proxyLSP(const std::string& rootPath) {
+    int fd = connectTo(rootPath);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Editor -> daemon. Left detached: it may sit in read(0) after the daemon
+    // ends the session, and the process exits right after anyway
+    std::thread([fd]() {
+        char buffer[64 * 1024];
+        ssize_t n;
+        while ((n = ::read(0, buffer, sizeof(buffer))) != 0) {
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            if (!sendAll(fd, buffer, static_cast<size_t>(n))) {
+                break;
+            }
+        }
+        ::shutdown(fd, SHUT_WR);
+    }).detach();
+
+    // Daemon -> editor, until the session ends
+    char buffer[64 * 1024];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (!writeAll(1, buffer, static_cast<size_t>(n))) {
+            break;
+        }
+    }
+    ::close(fd);
+    return true;
+}
+
+int DaemonClient::connectTo(const std::string& rootPath) {
+    std::string path = NavixDaemon::socketPath(rootPath);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef DAEMONCLIENT_HPP
+#define DAEMONCLIENT_HPP
+
+#include "Symbol.hpp"
+#include <string>
+#include <vector>
+
+// Client side of NavixDaemon. Every call returns false when no daemon serves
+// the root, and the caller falls back to indexing on its own.
+class DaemonClient {
+public:
+    static bool isRunning(const std::string& rootPath);
+
+    // --search / --search-exact against the daemon's index
+    static bool search(const std::string& rootPath, const std::string& query, bool fuzzy,
+                       std::vector<Symbol>& results);
+
+    // Relay stdin and stdout to the daemon's LSP endpoint until the
+    // daemon closes the session, so `navix <root> --lsp` shares its index
+    static bool proxyLSP(const std::string& rootPath);
+
+private:
+    static int connectTo(const std::string& rootPath);
+};
+
+#endif // DAEMONCLIENT_HPP
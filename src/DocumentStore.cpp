@@ -0,0 +1,230 @@
+#include "DocumentStore.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+TextDocument::TextDocument(std::string text, int64_t version)
+    : m_length(0)
+    , m_version(version)
+{
+    setText(std::move(text));
+}
+
+void TextDocument::replace(int startLine, int startCharacter, int endLine, int endCharacter, const std::string& text) {
+    size_t start = offsetAt(startLine, startCharacter);
+    size_t end = offsetAt(endLine, endCharacter);
+    if (end < start) {
+        std::swap(start, end);
+    }
+    replaceRange(start, end, text);
+}
+
+void TextDocument::setText(std::string text) {
+    m_original = std::move(text);
+    m_added.clear();
+    m_pieces.clear();
+    m_length = m_original.size();
+    if (m_length > 0) {
+        m_pieces.push_back({false, 0, m_length, countNewlines(m_original.data(), m_length)});
+    }
+}
+
+std::string TextDocument::getText() const {
+    std::string text;
+    text.reserve(m_length);
+    for (const Piece& piece : m_pieces) {
+        text.append(data(piece), piece.length);
+    }
+    return text;
+}
+
+std::string TextDocument::getLine(int line) const {
+    // A character past the end of the line clamps to the line break
+    return getRange(offsetAt(line, 0), offsetAt(line, std::numeric_limits<int>::max()));
+}
+
+std::string TextDocument::getRange(size_t start, size_t end) const {
+    std::string text;
+    size_t at = 0;
+    for (const Piece& piece : m_pieces) {
+        if (at >= end) {
+            break;
+        }
+        size_t from = std::max(start, at);
+        size_t to = std::min(end, at + piece.length);
+        if (from < to) {
+            text.append(data(piece) + (from - at), to - from);
+        }
+        at += piece.length;
+    }
+    return text;
+}
+
+size_t TextDocument::offsetAt(int line, int character) const {
+    // Find the piece and position where the line starts
+    size_t piece = 0;
+    size_t pos = 0;
+    size_t offset = 0;
+    if (line > 0) {
+        size_t remaining = static_cast<size_t>(line);
+        while (piece < m_pieces.size() && m_pieces[piece].newlines < remaining) {
+            remaining -= m_pieces[piece].newlines;
+            offset += m_pieces[piece].length;
+            piece++;
+        }
+        if (piece == m_pieces.size()) {
+            return m_length;
+        }
+
+        const char* begin = data(m_pieces[piece]);
+        const char* at = begin;
+        for (size_t i = 0; i < remaining; i++) {
+            at = static_cast<const char*>(std::memchr(at, '\n', begin + m_pieces[piece].length - at)) + 1;
+        }
+        pos = static_cast<size_t>(at - begin);
+        offset += pos;
+    }
+
+    // Walk the line counting UTF-16 code units, which is what LSP positions use
+    int units = 0;
+    while (units < character && piece < m_pieces.size()) {
+        if (pos == m_pieces[piece].length) {
+            piece++;
+            pos = 0;
+            continue;
+        }
+
+        unsigned char c = static_cast<unsigned char>(data(m_pieces[piece])[pos]);
+        if (c == '\n') {
+            break;
+        }
+
+        size_t bytes = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        units += bytes == 4 ? 2 : 1;
+
+        // A multi-byte sequence can straddle pieces
+        for (size_t i = 0; i < bytes && piece < m_pieces.size(); i++) {
+            pos++;
+            offset++;
+            if (pos == m_pieces[piece].length) {
+                piece++;
+                pos = 0;
+            }
+        }
+    }
+    return std::min(offset, m_length);
+}
+
+void TextDocument::replaceRange(size_t start, size_t end, const std::string& text) {
+    // Splitting at start first keeps its index valid: the end split lands at or after it
+    size_t first = splitAt(start);
+    size_t last = splitAt(end);
+    m_pieces.erase(m_pieces.begin() + first, m_pieces.begin() + last);
+    m_length -= end - start;
+
+    if (!text.empty()) {
+        size_t newlines = countNewlines(text.data(), text.size());
+
+        // Typing extends the piece it just appended instead of adding one per keystroke
+        if (first > 0 && m_pieces[first - 1].added &&
+            m_pieces[first - 1].start + m_pieces[first - 1].length == m_added.size()) {
+            m_pieces[first - 1].length += text.size();
+            m_pieces[first - 1].newlines += newlines;
+        } else {
+            m_pieces.insert(m_pieces.begin() + first, Piece{true, m_added.size(), text.size(), newlines});
+        }
+        m_added += text;
+        m_length += text.size();
+    }
+
+    if (m_pieces.size() > MAX_PIECES) {
+        compact();
+    }
+}
+
+size_t TextDocument::splitAt(size_t offset) {
+    size_t at = 0;
+    for (size_t i = 0; i < m_pieces.size(); i++) {
+        if (offset == at) {
+            return i;
+        }
+
+        Piece& piece = m_pieces[i];
+        if (offset < at + piece.length) {
+            size_t leftLength = offset - at;
+            size_t rightLength = piece.length - leftLength;
+            const char* begin = data(piece);
+
+            // Count newlines in the shorter half only
+            size_t leftNewlines;
+            if (leftLength <= rightLength) {
+                leftNewlines = countNewlines(begin, leftLength);
+            } else {
+                leftNewlines = piece.newlines - countNewlines(begin + leftLength, rightLength);
+            }
+
+            Piece right{piece.added, piece.start + leftLength, rightLength, piece.newlines - leftNewlines};
+            piece.length = leftLength;
+            piece.newlines = leftNewlines;
+            m_pieces.insert(m_pieces.begin() + i + 1, right);
+            return i + 1;
+        }
+        at += piece.length;
+    }
+    return m_pieces.size();
+}
+
+void TextDocument::compact() {
+    setText(getText());
+}
+
+const char* TextDocument::data(const Piece& piece) const {
+    return (piece.added ? m_added.data() : m_original.data()) + piece.start;
+}
+
+size_t TextDocument::countNewlines(const char* data, size_t length) {
+    size_t count = 0;
+    const char* end = data + length;
+    while ((data = static_cast<const char*>(std::memchr(data, '\n', end - data))) != nullptr) {
+        count++;
+        data++;
+    }
+    return count;
+}
+
+TextDocument& DocumentStore::open(const std::string& path, std::string text, int64_t version) {
+    auto it = m_documents.find(path);
+    if (it != m_documents.end()) {
+        it->second.setText(std::move(text));
+        it->second.setVersion(version);
+        return it->second;
+    }
+    return m_documents.emplace(path, TextDocument(std::move(text), version)).first->second;
+}
+
+void DocumentStore::close(const std::string& path) {
+    m_documents.erase(path);
+}
+
+TextDocument* DocumentStore::find(const std::string& path) {
+    auto it = m_documents.find(path);
+    return it == m_documents.end() ? nullptr : &it->second;
+}
+
+const TextDocument* DocumentStore::find(const std::string& path) const {
+    auto it = m_documents.find(path);
+    return it == m_documents.end() ? nullptr : &it->second;
+}
+
+bool DocumentStore::isOpen(const std::string& path) const {
+    return m_documents.count(path) > 0;
+}
+
+std::vector<std::string> DocumentStore::getPaths() const {
+    std::vector<std::string> paths;
+    paths.reserve(m_documents.size());
+    for (const auto& entry : m_documents) {
+        paths.push_back(entry.first);
+    }
+    return paths;
+}
@@ -0,0 +1,75 @@
+#ifndef DOCUMENTSTORE_HPP
+#define DOCUMENTSTORE_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Text of one open document as a piece table: the text the client opened
+// with, an append-only buffer of inserted text, and a list of pieces that
+// spell out the current contents. An edit appends its text and splits at
+// most two pieces, so a keystroke never copies the rest of the document.
+class TextDocument {
+public:
+    TextDocument(std::string text, int64_t version);
+
+    // Replace the range between two (line, UTF-16 character) positions, as
+    // sent in LSP contentChanges. Out-of-range positions clamp to the end
+    // of their line / the document.
+    void replace(int startLine, int startCharacter, int endLine, int endCharacter, const std::string& text);
+    void setText(std::string text);
+
+    std::string getText() const;
+    std::string getLine(int line) const;  // without the line break
+    size_t length() const { return m_length; }
+    size_t pieceCount() const { return m_pieces.size(); }
+
+    int64_t getVersion() const { return m_version; }
+    void setVersion(int64_t version) { m_version = version; }
+
+private:
+    struct Piece {
+        bool added;        // lives in m_added rather than m_original
+        size_t start;
+        size_t length;
+        size_t newlines;   // cached so line lookups skip whole pieces
+    };
+
+    // Fold everything back into one piece once edits fragment the table
+    static const size_t MAX_PIECES = 1024;
+
+    std::string m_original;
+    std::string m_added;
+    std::vector<Piece> m_pieces;
+    size_t m_length;
+    int64_t m_version;
+
+    size_t offsetAt(int line, int character) const;
+    std::string getRange(size_t start, size_t end) const;
+    void replaceRange(size_t start, size_t end, const std::string& text);
+    size_t splitAt(size_t offset);
+    void compact();
+
+    const char* data(const Piece& piece) const;
+    static size_t countNewlines(const char* data, size_t length);
+};
+
+// Documents the client has open, keyed by file path. While a document is
+// open its buffer, not the file on disk, is the source of truth.
+class DocumentStore {
+public:
+    TextDocument& open(const std::string& path, std::string text, int64_t version);
+    void close(const std::string& path);
+
+    TextDocument* find(const std::string& path);
+    const TextDocument* find(const std::string& path) const;
+    bool isOpen(const std::string& path) const;
+    std::vector<std::string> getPaths() const;
+    size_t size() const { return m_documents.size(); }
+
+private:
+    std::unordered_map<std::string, TextDocument> m_documents;
+};
+
+#endif // DOCUMENTSTORE_HPP
@@ -0,0 +1,96 @@
+#include "ExtensionSet.hpp"
+#include <algorithm>
+#include <cstring>
+
+ExtensionSet::ExtensionSet(std::initializer_list<std::string> extensions) {
+    for (const auto& extension : extensions) {
+        add(extension);
+    }
+}
+
+ExtensionSet::ExtensionSet(const std::vector<std::string>& extensions) {
+    for (const auto& extension : extensions) {
+        add(extension);
+    }
+}
+
+void ExtensionSet::add(const std::string& extension) {
+    if (extension.empty() || contains(extension)) {
+        return;
+    }
+    
+    if (extension.size() <= MAX_PACKED_LENGTH) {
+        uint64_t key = pack(extension.data(), extension.size());
+        m_packed.insert(std::lower_bound(m_packed.begin(), m_packed.end(), key), key);
+    } else {
+        m_long.push_back(extension);
+    }
+    m_maxLength = std::max(m_maxLength, extension.size());
+}
+
+bool ExtensionSet::matches(const std::string& path) const {
+    // Only the last m_maxLength bytes can hold a matching extension
+    size_t limit = std::min(path.size(), m_maxLength);
+    
+    for (size_t length = 1; length <= limit; length++) {
+        size_t dot = path.size() - length;
+        char c = path[dot];
+        if (c == '/' || c == '\\') {
+            return false;
+        }
+        if (c != '.') {
+            continue;
+        }
+        
+        // A dot that starts the file name marks a hidden file, not an extension
+        if (dot == 0 || path[dot - 1] == '/' || path[dot - 1] == '\\') {
+            return false;
+        }
+        return containsSuffix(path.data() + dot, length);
+    }
+    return false;
+}
+
+bool ExtensionSet::contains(const std::string& extension) const {
+    return containsSuffix(extension.data(), extension.size());
+}
+
+std::vector<std::string> ExtensionSet::getExtensions() const {
+    std::vector<std::string> extensions;
+    for (uint64_t key : m_packed) {
+        char buffer[MAX_PACKED_LENGTH];
+        std::memcpy(buffer, &key, MAX_PACKED_LENGTH);
+        extensions.emplace_back(buffer, strnlen(buffer, MAX_PACKED_LENGTH));
+    }
+    extensions.insert(extensions.end(), m_long.begin(), m_long.end());
+    return extensions;
+}
+
+size_t ExtensionSet::size() const {
+    return m_packed.size() + m_long.size();
+}
+
+bool ExtensionSet::empty() const {
+    return size() == 0;
+}
+
+bool ExtensionSet::containsSuffix(const char* data, size_t length) const {
+    if (length == 0 || length > m_maxLength) {
+        return false;
+    }
+    
+    if (length <= MAX_PACKED_LENGTH) {
+        return std::binary_search(m_packed.begin(), m_packed.end(), pack(data, length));
+    }
+    
+    return std::any_of(m_long.begin(), m_long.end(), [data, length](const std::string& extension) {
+        return extension.size() == length && std::memcmp(extension.data(), data, length) == 0;
+    });
+}
+
+uint64_t ExtensionSet::pack(const char* data, size_t length) {
+    // Zero padding keeps ".h" and ".hpp" distinct; extensions never contain NUL
+    uint64_t key = 0;
+    std::memcpy(&key, data, length);
+    return key;
+}
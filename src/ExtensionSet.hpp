@@ -0,0 +1,41 @@
+#ifndef EXTENSIONSET_HPP
+#define EXTENSIONSET_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
+
+// Precompiled set of file extensions (".cpp", ".gemspec", ...). Extensions of
+// up to 8 bytes are packed into integers and kept sorted, so matching a path
+// is a backwards scan for the last '.', one pack and a binary search: no
+// allocation and no std::filesystem::path construction per lookup.
+class ExtensionSet {
+public:
+    ExtensionSet() = default;
+    ExtensionSet(std::initializer_list<std::string> extensions);
+    explicit ExtensionSet(const std::vector<std::string>& extensions);
+    
+    void add(const std::string& extension);
+    
+    // Same rule as std::filesystem::path::extension(): the suffix from the last
+    // '.' of the file name, where a leading dot does not start an extension
+    bool matches(const std::string& path) const;
+    bool contains(const std::string& extension) const;
+    
+    std::vector<std::string> getExtensions() const;
+    size_t size() const;
+    bool empty() const;
+    
+private:
+    static const size_t MAX_PACKED_LENGTH = 8;
+    
+    std::vector<uint64_t> m_packed;      // sorted
+    std::vector<std::string> m_long;     // extensions too long to pack
+    size_t m_maxLength = 0;
+    
+    bool containsSuffix(const char* data, size_t length) const;
+    static uint64_t pack(const char* data, size_t length);
+};
+
+#endif // EXTENSIONSET_HPP
@@ -24,8 +24,8 @@ std::vector<std::string> FileScanner::scanForSwift(const std::string& rootPath)
     return scanByExtensions(rootPath, swiftExtensions);
 }
 
-std::vector<std::string> FileScanner::scanForAllSupportedFiles(const std::string& rootPath) {
-    std::vector<std::string> allExtensions = {
+const ExtensionSet& FileScanner::getSupportedExtensions() {
+    static const ExtensionSet allExtensions = {
         // C++ files
         ".cpp", ".hpp", ".h", ".cc", ".cxx",
         // TypeScript/JavaScript files  
@@ -51,7 +51,11 @@ std::vector<std::string> FileScanner::scanForAllSupportedFiles(const std::string
         // Text files
         ".txt", ".text", ".md", ".rst", ".log", ".readme", ".doc"
     };
-    return scanByExtensions(rootPath, allExtensions);
+    return allExtensions;
+}
+
+std::vector<std::string> FileScanner::scanForAllSupportedFiles(const std::string& rootPath) {
+    return scanByExtensions(rootPath, getSupportedExtensions());
 }
 
 std::vector<std::string> FileScanner::scanForTypeScriptJavaScript(const std::string& rootPath) {
@@ -105,14 +109,18 @@ std::vector<std::string> FileScanner::scanForRust(const std::string& rootPath) {
 }
 
 std::vector<std::string> FileScanner::scanByExtensions(const std::string& rootPath, const std::vector<std::string>& extensions) {
+    return scanByExtensions(rootPath, ExtensionSet(extensions));
+}
+
+std::vector<std::string> FileScanner::scanByExtensions(const std::string& rootPath, const ExtensionSet& extensions) {
     std::vector<std::string> files;
 
     try {
         for (const auto& entry : fs::recursive_directory_iterator(rootPath)) {
             if (entry.is_regular_file()) {
-                std::string ext = entry.path().extension().string();
-                if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) {
-                    files.push_back(entry.path().string());
+                std::string path = entry.path().string();
+                if (extensions.matches(path)) {
+                    files.push_back(path);
                 }
             }
         }
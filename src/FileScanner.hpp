@@ -7,9 +7,14 @@
 #include <thread>
 #include <atomic>
 #include "Symbol.hpp"
+#include "ExtensionSet.hpp"
 
 class FileScanner {
 public:
+    // Every extension SymbolIndex can parse. Built once and shared by the
+    // full scan and the live watcher so both always cover the same languages
+    static const ExtensionSet& getSupportedExtensions();
+    
     static std::vector<std::string> scanForCppFiles(const std::string& rootPath);
     static std::vector<std::string> scanForAllSupportedFiles(const std::string& rootPath);
     static std::vector<std::string> scanForTypeScriptJavaScript(const std::string& rootPath);
@@ -24,6 +29,7 @@ public:
     static std::vector<std::string> scanForRuby(const std::string& rootPath);
     static std::vector<std::string> scanForRust(const std::string& rootPath);
     static std::vector<std::string> scanByExtensions(const std::string& rootPath, const std::vector<std::string>& extensions);
+    static std::vector<std::string> scanByExtensions(const std::string& rootPath, const ExtensionSet& extensions);
     static std::vector<std::string> scanByFilenames(const std::string& rootPath, const std::vector<std::string>& filenames);
     static std::vector<std::string> scanByPattern(const std::string& rootPath, const std::string& pattern);
     
@@ -1,8 +1,10 @@
 #include "FileWatcher.hpp"
+#include "WatchJournal.hpp"
 #include <iostream>
 #include <filesystem>
 #include <algorithm>
 #include <thread>
+#include <cstring>
 
 #ifdef __APPLE__
 #include <sys/event.h>
@@ -11,24 +13,57 @@
 #include <unistd.h>
 #elif __linux__
 #include <sys/inotify.h>
+#include <sys/fanotify.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <climits>
+#include <cerrno>
 #endif
 
 FileWatcher::FileWatcher() 
     : m_running(false)
     , m_watching(false)
+    , m_useFanotify(false)
+    , m_usePolling(false)
+    , m_pollInterval(std::chrono::milliseconds(1000))
+    , m_pollBudget(std::chrono::milliseconds(50))
     , m_watchedFileCount(0)
+    , m_watchedDirectoryCount(0)
     , m_changeEventCount(0)
+    , m_eventsRead(0)
+    , m_queueDepth(0)
+    , m_peakQueueDepth(0)
+    , m_drainRate(0.0)
+    , m_eventsDropped(0)
+    , m_eventsDelivered(0)
+    , m_overflowCount(0)
     , m_debounceTime(std::chrono::milliseconds(100))
     , m_maxEvents(1000)
+    , m_debouncer(m_debounceTime)
+    , m_statPool(nullptr)
 #ifdef __APPLE__
     , m_kqueue(-1)
 #elif __linux__
     , m_inotify(-1)
-#else
-    , m_lastScan(std::chrono::system_clock::now())
+    , m_lastDrainTime(std::chrono::system_clock::now())
+    , m_epoll(-1)
+    , m_wakeFd(-1)
+    , m_fanotify(-1)
+    , m_mountFd(-1)
 #endif
+    , m_pollCursor(0)
+    , m_pollLap(0)
 {
+#ifdef __APPLE__
+    m_backend = WatchBackend::KQUEUE;
+#elif __linux__
+    m_backend = WatchBackend::INOTIFY;
+#else
+    m_backend = WatchBackend::POLLING;
+#endif
 }
 
 FileWatcher::~FileWatcher() {
@@ -36,6 +71,10 @@ FileWatcher::~FileWatcher() {
 }
 
 bool FileWatcher::startWatching(const std::string& rootPath, const std::vector<std::string>& extensions) {
+    return startWatching(rootPath, ExtensionSet(extensions));
+}
+
+bool FileWatcher::startWatching(const std::string& rootPath, const ExtensionSet& extensions) {
     if (m_watching) {
         return false;
     }
@@ -45,11 +84,63 @@ bool FileWatcher::startWatching(const std::string& rootPath, const std::vector<s
     m_running = true;
     m_watching = true;
     m_changeEventCount = 0;
+    m_eventsRead = 0;
+    m_eventsDropped = 0;
+    m_eventsDelivered = 0;
+    m_overflowCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_deliveryLatency.reset();
+    }
+    m_peakQueueDepth = 0;
+    
+#ifdef __linux__
+    // The inotify instance must exist before the scan so directory watches
+    // are created while walking the tree
+    try {
+        m_backend = WatchBackend::INOTIFY;
+        if (m_usePolling) {
+            m_backend = WatchBackend::POLLING;
+        } else if (m_useFanotify && setupFanotify()) {
+            m_backend = WatchBackend::FANOTIFY;
+        } else {
+            setupInotify();
+        }
+        
+        int eventFd = -1;
+        if (m_backend == WatchBackend::FANOTIFY) {
+            eventFd = m_fanotify;
+        } else if (m_backend == WatchBackend::INOTIFY) {
+            eventFd = m_inotify;
+        }
+        setupEpoll(eventFd);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ File watcher error: " << e.what() << "\n";
+        cleanupEpoll();
+        cleanupInotify();
+        cleanupFanotify();
+        m_running = false;
+        m_watching = false;
+        return false;
+    }
+#elif __APPLE__
+    m_backend = m_usePolling ? WatchBackend::POLLING : WatchBackend::KQUEUE;
+#endif
+    
+    m_polledDirectories.clear();
+    m_pollOrder.clear();
+    m_pollCursor = 0;
+    m_pollLap = 0;
     
     // Initial scan to populate watched files
     scanDirectory(rootPath);
+    openJournal();
     
-    std::cout << "🔍 Starting file watcher for " << m_watchedFileCount << " files...\n";
+    std::cout << "🔍 Starting file watcher for " << m_watchedFileCount << " files";
+    if (m_watchedDirectoryCount > 0) {
+        std::cout << " in " << m_watchedDirectoryCount << " directories";
+    }
+    std::cout << " (" << getBackendName() << ")...\n";
     
     // Start the watch thread
     m_watchThread = std::thread([this]() {
@@ -65,26 +156,48 @@ bool FileWatcher::startWatching(const std::string& rootPath, const std::vector<s
 }
 
 void FileWatcher::stopWatching() {
-    if (!m_watching) {
+    // The thread may have exited on an error and still need joining
+    if (!m_watching && !m_watchThread.joinable()) {
         return;
     }
     
     m_running = false;
     m_watching = false;
     
+#ifdef __linux__
+    // Interrupt epoll_wait so shutdown does not wait for a timeout
+    if (m_wakeFd != -1) {
+        uint64_t one = 1;
+        ssize_t ignored = write(m_wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+#endif
+    
     if (m_watchThread.joinable()) {
         m_watchThread.join();
     }
     
+    // Deliver whatever was still waiting out its debounce window
+    flushDebounced(true);
+    
+    // A clean stop leaves a compact snapshot and an empty journal
+    if (m_journal) {
+        m_journal->writeSnapshot(m_journal->getState());
+        m_journal.reset();
+    }
+    
 #ifdef __APPLE__
     cleanupKqueue();
 #elif __linux__
+    cleanupEpoll();
     cleanupInotify();
+    cleanupFanotify();
 #endif
     
     std::lock_guard<std::mutex> lock(m_stateMutex);
     m_watchedFiles.clear();
     m_watchedFileCount = 0;
+    m_watchedDirectoryCount = 0;
     
     std::cout << "⏹️  File watcher stopped\n";
 }
@@ -93,6 +206,10 @@ void FileWatcher::setChangeCallback(ChangeCallback callback) {
     m_callback = callback;
 }
 
+void FileWatcher::setBatchCallback(BatchCallback callback) {
+    m_batchCallback = callback;
+}
+
 bool FileWatcher::isWatching() const {
     return m_watching;
 }
@@ -101,12 +218,93 @@ size_t FileWatcher::getWatchedFileCount() const {
     return m_watchedFileCount;
 }
 
+size_t FileWatcher::getWatchedDirectoryCount() const {
+    return m_watchedDirectoryCount;
+}
+
 size_t FileWatcher::getChangeEventCount() const {
     return m_changeEventCount;
 }
 
+size_t FileWatcher::getEventsRead() const {
+    return m_eventsRead;
+}
+
+size_t FileWatcher::getQueueDepth() const {
+    return m_queueDepth;
+}
+
+size_t FileWatcher::getPeakQueueDepth() const {
+    return m_peakQueueDepth;
+}
+
+double FileWatcher::getDrainRate() const {
+    return m_drainRate;
+}
+
+WatcherStats FileWatcher::getStats() const {
+    WatcherStats stats;
+    stats.backend = m_backend;
+    stats.watchedFiles = m_watchedFileCount;
+    stats.watchedDirectories = m_watchedDirectoryCount;
+    stats.eventsRead = m_eventsRead;
+    stats.eventsCoalesced = m_debouncer.getCoalescedCount();
+    stats.eventsDropped = m_eventsDropped;
+    stats.eventsDelivered = m_eventsDelivered;
+    stats.overflows = m_overflowCount;
+    stats.queueDepth = m_queueDepth;
+    stats.peakQueueDepth = m_peakQueueDepth;
+    stats.drainRate = m_drainRate;
+    
+    switch (stats.backend) {
+        case WatchBackend::FANOTIFY: stats.watches = 1; break;
+        case WatchBackend::KQUEUE: stats.watches = stats.watchedFiles; break;
+        default: stats.watches = stats.watchedDirectories; break;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    stats.deliveryLatency = m_deliveryLatency;
+    return stats;
+}
+
+WatchBackend FileWatcher::getBackend() const {
+    return m_backend;
+}
+
+std::string FileWatcher::getBackendName() const {
+    switch (m_backend.load()) {
+        case WatchBackend::INOTIFY: return "inotify";
+        case WatchBackend::FANOTIFY: return "fanotify";
+        case WatchBackend::KQUEUE: return "kqueue";
+        case WatchBackend::POLLING: return "polling";
+    }
+    return "unknown";
+}
+
+void FileWatcher::setUseFanotify(bool enabled) {
+    m_useFanotify = enabled;
+}
+
+void FileWatcher::setUsePolling(bool enabled) {
+    m_usePolling = enabled;
+}
+
+void FileWatcher::setPollInterval(std::chrono::milliseconds interval) {
+    m_pollInterval = interval;
+}
+
+void FileWatcher::setPollBudget(std::chrono::milliseconds budget) {
+    m_pollBudget = budget;
+}
+
+void FileWatcher::setJournalDirectory(const std::string& directory, ThreadPool& statPool) {
+    m_journalDirectory = directory;
+    m_statPool = &statPool;
+}
+
 void FileWatcher::setDebounceTime(std::chrono::milliseconds ms) {
     m_debounceTime = ms;
+    m_debouncer.setWindow(ms);
 }
 
 void FileWatcher::setMaxEvents(size_t maxEvents) {
@@ -114,12 +312,19 @@ void FileWatcher::setMaxEvents(size_t maxEvents) {
 }
 
 void FileWatcher::watchLoop() {
+    if (m_backend == WatchBackend::POLLING) {
+        pollLoop();
+        return;
+    }
+    
 #ifdef __APPLE__
     setupKqueue();
     
     while (m_running) {
         struct kevent events[64];
-        struct timespec timeout = {1, 0}; // 1 second timeout
+        auto wait = nextWakeup();
+        struct timespec timeout = {static_cast<time_t>(wait.count() / 1000), 
+                                   static_cast<long>((wait.count() % 1000) * 1000000)};
         
         int eventCount = kevent(m_kqueue, nullptr, 0, events, 64, &timeout);
         
@@ -137,58 +342,40 @@ void FileWatcher::watchLoop() {
                 }
             }
         }
+        
+        flushDebounced();
     }
     
 #elif __linux__
-    setupInotify();
+    int eventFd = m_backend == WatchBackend::FANOTIFY ? m_fanotify : m_inotify;
+    
+    // Big enough to empty a burst of thousands of events in a few reads
+    std::vector<char> buffer(256 * 1024);
     
-    char buffer[4096];
     while (m_running) {
-        fd_set readfds;
-        FD_ZERO(&readfds);
-        FD_SET(m_inotify, &readfds);
+        struct epoll_event ready[2];
         
-        struct timeval timeout = {1, 0}; // 1 second timeout
-        int result = select(m_inotify + 1, &readfds, nullptr, nullptr, &timeout);
+        // Wake up on the next wheel tick while changes are pending
+        int timeoutMs = static_cast<int>(nextWakeup().count());
+        int readyCount = epoll_wait(m_epoll, ready, 2, timeoutMs);
         
-        if (result > 0 && FD_ISSET(m_inotify, &readfds)) {
-            ssize_t length = read(m_inotify, buffer, sizeof(buffer));
-            
-            if (length > 0) {
-                size_t offset = 0;
-                while (offset < static_cast<size_t>(length)) {
-                    struct inotify_event* event = reinterpret_cast<struct inotify_event*>(buffer + offset);
-                    
-                    if (event->len > 0) {
-                        std::string path = std::string(event->name);
-                        
-                        if (event->mask & IN_MODIFY) {
-                            handleFileChange(path, FileEvent::MODIFIED);
-                        } else if (event->mask & IN_CREATE) {
-                            handleFileChange(path, FileEvent::CREATED);
-                        } else if (event->mask & IN_DELETE) {
-                            handleFileChange(path, FileEvent::DELETED);
-                        }
-                    }
-                    
-                    offset += sizeof(struct inotify_event) + event->len;
-                }
+        if (readyCount == -1 && errno != EINTR) {
+            throw std::runtime_error("epoll_wait failed: " + std::string(std::strerror(errno)));
+        }
+        
+        for (int i = 0; i < readyCount; ++i) {
+            if (ready[i].data.fd == eventFd) {
+                drainEvents(eventFd, buffer);
             }
         }
-    }
-    
-#else
-    // Fallback polling implementation
-    while (m_running) {
-        pollForChanges();
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        
+        flushDebounced();
     }
 #endif
 }
 
 bool FileWatcher::isFileRelevant(const std::string& path) const {
-    std::string ext = getFileExtension(path);
-    return std::find(m_extensions.begin(), m_extensions.end(), ext) != m_extensions.end();
+    return m_extensions.matches(path);
 }
 
 void FileWatcher::handleFileChange(const std::string& path, FileEvent event) {
@@ -198,30 +385,424 @@ void FileWatcher::handleFileChange(const std::string& path, FileEvent event) {
     
     m_changeEventCount++;
     
-    if (m_callback) {
-        FileChange change(path, event);
-        debounceAndNotify(change);
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        if (event == FileEvent::CREATED) {
+            m_watchedFiles.insert(path);
+        } else if (event == FileEvent::DELETED) {
+            m_watchedFiles.erase(path);
+        }
+        m_watchedFileCount = m_watchedFiles.size();
+    }
+    
+    if (m_callback || m_batchCallback) {
+        m_debouncer.add(path, event, ChangeDebouncer::Clock::now());
+    }
+}
+
+void FileWatcher::handleFileMove(const std::string& oldPath, const std::string& newPath) {
+    bool wasRelevant = isFileRelevant(oldPath);
+    bool isRelevant = isFileRelevant(newPath);
+    
+    // Renaming across the extension filter looks like a plain create or delete
+    if (!wasRelevant || !isRelevant) {
+        if (wasRelevant) {
+            handleFileChange(oldPath, FileEvent::DELETED);
+        } else {
+            handleFileChange(newPath, FileEvent::CREATED);
+        }
+        return;
+    }
+    
+    m_changeEventCount++;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_watchedFiles.erase(oldPath);
+        m_watchedFiles.insert(newPath);
+        m_watchedFileCount = m_watchedFiles.size();
+    }
+    
+    if (m_callback || m_batchCallback) {
+        m_debouncer.addMove(oldPath, newPath, ChangeDebouncer::Clock::now());
+    }
+}
+
+void FileWatcher::handleDirectoryMove(const std::string& oldPath, const std::string& newPath) {
+    std::string prefix = oldPath + "/";
+    std::vector<std::string> movedFiles;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        
+#ifdef __linux__
+        // Watches follow the inode, only their recorded paths go stale
+        for (auto& entry : m_watchDirectories) {
+            if (entry.second == oldPath || entry.second.compare(0, prefix.size(), prefix) == 0) {
+                m_directoryWatches.erase(entry.second);
+                entry.second = newPath + entry.second.substr(oldPath.size());
+                m_directoryWatches[entry.second] = entry.first;
+            }
+        }
+#endif
+        
+        for (const auto& filePath : m_watchedFiles) {
+            if (filePath.compare(0, prefix.size(), prefix) == 0) {
+                movedFiles.push_back(filePath);
+            }
+        }
+    }
+    
+    for (const auto& filePath : movedFiles) {
+        handleFileMove(filePath, newPath + filePath.substr(oldPath.size()));
+    }
+}
+
+void FileWatcher::handleDirectoryRemoved(const std::string& path) {
+    std::string prefix = path + "/";
+    std::vector<std::string> removedFiles;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        
+#ifdef __linux__
+        std::vector<int> staleWatches;
+        for (const auto& entry : m_watchDirectories) {
+            if (entry.second == path || entry.second.compare(0, prefix.size(), prefix) == 0) {
+                staleWatches.push_back(entry.first);
+            }
+        }
+        for (int wd : staleWatches) {
+            inotify_rm_watch(m_inotify, wd);
+            removeWatchDescriptor(wd);
+        }
+#endif
+        
+        for (const auto& filePath : m_watchedFiles) {
+            if (filePath.compare(0, prefix.size(), prefix) == 0) {
+                removedFiles.push_back(filePath);
+            }
+        }
+    }
+    
+    for (const auto& filePath : removedFiles) {
+        handleFileChange(filePath, FileEvent::DELETED);
     }
 }
 
-void FileWatcher::debounceAndNotify(const FileChange& change) {
-    // Simple debouncing - could be improved with a proper debounce mechanism
-    std::this_thread::sleep_for(m_debounceTime);
+void FileWatcher::flushDebounced(bool force) {
+    std::vector<FileChange> changes = force ? m_debouncer.flushAll() 
+                                            : m_debouncer.collectReady(ChangeDebouncer::Clock::now());
+    if (changes.empty()) {
+        if (m_journal) {
+            m_journal->syncIfDue();
+        }
+        return;
+    }
+    
+    {
+        auto now = std::chrono::system_clock::now();
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        for (const auto& change : changes) {
+            m_deliveryLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(now - change.timestamp));
+        }
+    }
+    m_eventsDelivered += changes.size();
     
+    if (m_batchCallback) {
+        m_batchCallback(changes);
+    }
     if (m_callback) {
-        m_callback(change);
+        for (const auto& change : changes) {
+            m_callback(change);
+        }
+    }
+    
+    if (m_journal) {
+        m_journal->append(changes);
+        if (m_journal->needsSnapshot()) {
+            m_journal->writeSnapshot(m_journal->getState());
+        }
+    }
+}
+
+void FileWatcher::openJournal() {
+    if (m_journalDirectory.empty() || !m_statPool) {
+        return;
+    }
+    
+    m_journal = std::make_unique<WatchJournal>(m_journalDirectory, m_rootPath);
+    if (!m_journal->open()) {
+        m_journal.reset();
+        return;
+    }
+    
+    std::vector<std::string> files;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        files.assign(m_watchedFiles.begin(), m_watchedFiles.end());
+    }
+    WatchJournal::FileTable current = WatchJournal::statFiles(files, *m_statPool);
+    
+    // First run for this root: the scan is the baseline
+    if (!m_journal->hasState()) {
+        m_journal->writeSnapshot(current);
+        return;
+    }
+    
+    // Catch-up changes go through the debouncer like live ones and are
+    // journaled on delivery, so a crash before then replays them again
+    std::vector<FileChange> missed = m_journal->diff(current);
+    if (!missed.empty()) {
+        std::cout << "⏪ " << missed.size() << " files changed while the watcher was stopped\n";
+    }
+    for (const auto& change : missed) {
+        handleFileChange(change.path, change.event);
+    }
+}
+
+std::chrono::milliseconds FileWatcher::nextWakeup() const {
+    return m_debouncer.hasPending() ? m_debouncer.getTick() : std::chrono::milliseconds(1000);
+}
+
+ChangeDebouncer::ChangeDebouncer(std::chrono::milliseconds window, std::chrono::milliseconds tick)
+    : m_window(window)
+    , m_tick(std::max(tick, std::chrono::milliseconds(1)))
+    , m_epoch(Clock::now())
+    , m_nextTick(0)
+    , m_coalescedCount(0)
+{
+    setWindow(window);
+}
+
+void ChangeDebouncer::setWindow(std::chrono::milliseconds window) {
+    m_window = window;
+    
+    // One revolution spans the window, so most entries expire on their first visit
+    std::vector<FileChange> pending = flushAll();
+    m_wheel.assign(static_cast<size_t>(window / m_tick) + 2, {});
+    m_nextTick = tickFor(Clock::now());
+    
+    auto now = Clock::now();
+    for (const auto& change : pending) {
+        if (change.event == FileEvent::MOVED) {
+            addMove(change.oldPath, change.path, now);
+        } else {
+            add(change.path, change.event, now);
+        }
+    }
+}
+
+std::chrono::milliseconds ChangeDebouncer::getTick() const {
+    return m_tick;
+}
+
+uint64_t ChangeDebouncer::tickFor(Clock::time_point time) const {
+    return static_cast<uint64_t>((time - m_epoch) / m_tick);
+}
+
+void ChangeDebouncer::add(const std::string& path, FileEvent event, Clock::time_point now) {
+    // Round up so a path is never released before a full window has passed
+    uint64_t deadline = tickFor(now + m_window) + 1;
+    
+    auto it = m_pending.find(path);
+    if (it == m_pending.end()) {
+        PendingChange pending;
+        pending.existedBefore = event != FileEvent::CREATED;
+        pending.existsNow = event != FileEvent::DELETED;
+        pending.modifiedAfterMove = false;
+        pending.deadlineTick = deadline;
+        pending.firstSeen = std::chrono::system_clock::now();
+        m_pending.emplace(path, std::move(pending));
+    } else {
+        it->second.existsNow = event != FileEvent::DELETED;
+        it->second.modifiedAfterMove = !it->second.movedFrom.empty();
+        it->second.deadlineTick = deadline;
+        m_coalescedCount++;
+    }
+    
+    // Earlier wheel entries for the path go stale and are skipped on expiry
+    m_wheel[deadline % m_wheel.size()].push_back(path);
+}
+
+void ChangeDebouncer::addMove(const std::string& oldPath, const std::string& newPath, 
+                              Clock::time_point now) {
+    uint64_t deadline = tickFor(now + m_window) + 1;
+    
+    PendingChange pending;
+    pending.existedBefore = true;
+    pending.existsNow = true;
+    pending.modifiedAfterMove = false;
+    pending.movedFrom = oldPath;
+    pending.deadlineTick = deadline;
+    pending.firstSeen = std::chrono::system_clock::now();
+    
+    // Whatever was pending on the old path travels with the file
+    auto old = m_pending.find(oldPath);
+    if (old != m_pending.end()) {
+        if (!old->second.existedBefore) {
+            pending.existedBefore = false;   // created in this window: a create at the new path
+            pending.movedFrom.clear();
+        } else {
+            if (!old->second.movedFrom.empty()) {
+                pending.movedFrom = old->second.movedFrom;
+            }
+            pending.modifiedAfterMove = old->second.movedFrom.empty() || old->second.modifiedAfterMove;
+        }
+        pending.firstSeen = old->second.firstSeen;
+        m_pending.erase(old);
+        m_coalescedCount++;
     }
+    
+    // A rename that lands back on its origin is only a modification, if anything
+    if (pending.movedFrom == newPath) {
+        pending.movedFrom.clear();
+    }
+    
+    // A file replaced by the rename is superseded by it
+    auto replaced = m_pending.find(newPath);
+    if (replaced != m_pending.end()) {
+        m_pending.erase(replaced);
+        m_coalescedCount++;
+    }
+    
+    m_pending.emplace(newPath, std::move(pending));
+    m_wheel[deadline % m_wheel.size()].push_back(newPath);
+}
+
+std::vector<FileChange> ChangeDebouncer::collectReady(Clock::time_point now) {
+    std::vector<FileChange> ready;
+    uint64_t nowTick = tickFor(now);
+    
+    if (m_pending.empty()) {
+        m_nextTick = nowTick + 1;
+        for (auto& slot : m_wheel) {
+            slot.clear();
+        }
+        return ready;
+    }
+    
+    // After a long stall one revolution visits every slot
+    uint64_t first = std::max(m_nextTick, nowTick + 1 > m_wheel.size() ? nowTick + 1 - m_wheel.size() : 0);
+    for (uint64_t tick = first; tick <= nowTick; ++tick) {
+        expireSlot(static_cast<size_t>(tick % m_wheel.size()), nowTick, ready);
+    }
+    m_nextTick = std::max(m_nextTick, nowTick + 1);
+    
+    return ready;
+}
+
+void ChangeDebouncer::expireSlot(size_t slot, uint64_t nowTick, std::vector<FileChange>& ready) {
+    std::vector<std::string>& paths = m_wheel[slot];
+    size_t kept = 0;
+    
+    for (size_t i = 0; i < paths.size(); ++i) {
+        auto it = m_pending.find(paths[i]);
+        if (it == m_pending.end() || it->second.deadlineTick % m_wheel.size() != slot) {
+            continue; // stale entry from before the path was touched again
+        }
+        
+        if (it->second.deadlineTick > nowTick) {
+            if (kept != i) {
+                paths[kept] = std::move(paths[i]);
+            }
+            kept++; // due on a later lap
+            continue;
+        }
+        
+        appendNetChange(paths[i], it->second, ready);
+        m_pending.erase(it);
+    }
+    
+    paths.resize(kept);
+}
+
+std::vector<FileChange> ChangeDebouncer::flushAll() {
+    std::vector<FileChange> ready;
+    ready.reserve(m_pending.size());
+    
+    for (const auto& entry : m_pending) {
+        appendNetChange(entry.first, entry.second, ready);
+    }
+    
+    m_pending.clear();
+    for (auto& slot : m_wheel) {
+        slot.clear();
+    }
+    return ready;
+}
+
+void ChangeDebouncer::appendNetChange(const std::string& path, const PendingChange& pending, 
+                                      std::vector<FileChange>& ready) const {
+    // Created then deleted inside one window: nothing happened
+    if (!pending.existedBefore && !pending.existsNow) {
+        return;
+    }
+    
+    if (!pending.movedFrom.empty()) {
+        if (!pending.existsNow) {
+            ready.emplace_back(pending.movedFrom, FileEvent::DELETED);
+            ready.back().timestamp = pending.firstSeen;
+            return;
+        }
+        
+        // Consumers can relocate existing symbols, then reparse only if the content changed
+        ready.emplace_back(pending.movedFrom, path);
+        ready.back().timestamp = pending.firstSeen;
+        if (!pending.modifiedAfterMove) {
+            return;
+        }
+    }
+    
+    FileEvent net = FileEvent::MODIFIED;
+    if (!pending.existedBefore) {
+        net = FileEvent::CREATED;
+    } else if (!pending.existsNow) {
+        net = FileEvent::DELETED;
+    }
+    
+    ready.emplace_back(path, net);
+    ready.back().timestamp = pending.firstSeen;
+}
+
+bool ChangeDebouncer::hasPending() const {
+    return !m_pending.empty();
+}
+
+size_t ChangeDebouncer::getPendingCount() const {
+    return m_pending.size();
 }
 
-void FileWatcher::scanDirectory(const std::string& path) {
+size_t ChangeDebouncer::getCoalescedCount() const {
+    return m_coalescedCount;
+}
+
+void FileWatcher::scanDirectory(const std::string& path, bool notifyNewFiles) {
+    std::vector<std::string> newFiles;
+    
     try {
         std::lock_guard<std::mutex> lock(m_stateMutex);
         
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
-            if (entry.is_regular_file()) {
+#ifdef __linux__
+        addDirectoryToInotify(path);
+#endif
+        if (m_backend == WatchBackend::POLLING) {
+            trackPolledDirectory(path);
+        }
+        
+        auto options = std::filesystem::directory_options::skip_permission_denied;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path, options)) {
+            if (entry.is_directory()) {
+#ifdef __linux__
+                addDirectoryToInotify(entry.path().string());
+#endif
+                if (m_backend == WatchBackend::POLLING) {
+                    trackPolledDirectory(entry.path().string());
+                }
+            } else if (entry.is_regular_file()) {
                 std::string filePath = entry.path().string();
-                if (isFileRelevant(filePath)) {
-                    m_watchedFiles.insert(filePath);
+                if (isFileRelevant(filePath) && m_watchedFiles.insert(filePath).second) {
+                    newFiles.push_back(filePath);
                 }
             }
         }
@@ -231,14 +812,13 @@ void FileWatcher::scanDirectory(const std::string& path) {
     } catch (const std::exception& e) {
         std::cerr << "❌ Error scanning directory " << path << ": " << e.what() << "\n";
     }
-}
-
-std::string FileWatcher::getFileExtension(const std::string& path) const {
-    size_t pos = path.find_last_of('.');
-    if (pos != std::string::npos) {
-        return path.substr(pos);
+    
+    // Files created before a new directory's watch existed produce no events of their own
+    if (notifyNewFiles) {
+        for (const auto& filePath : newFiles) {
+            handleFileChange(filePath, FileEvent::CREATED);
+        }
     }
-    return "";
 }
 
 #ifdef __APPLE__
@@ -274,15 +854,89 @@ void FileWatcher::removeFileFromKqueue(const std::string& path) {
 }
 
 #elif __linux__
+void FileWatcher::setupEpoll(int eventFd) {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epoll == -1 || m_wakeFd == -1) {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+    
+    // The polling backend only needs the shutdown eventfd
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = eventFd;
+    if (eventFd != -1 && epoll_ctl(m_epoll, EPOLL_CTL_ADD, eventFd, &event) == -1) {
+        throw std::runtime_error("Failed to register watch descriptor with epoll");
+    }
+    
+    event.data.fd = m_wakeFd;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeFd, &event) == -1) {
+        throw std::runtime_error("Failed to register shutdown eventfd with epoll");
+    }
+}
+
+void FileWatcher::cleanupEpoll() {
+    if (m_epoll != -1) {
+        close(m_epoll);
+        m_epoll = -1;
+    }
+    if (m_wakeFd != -1) {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+}
+
+void FileWatcher::drainEvents(int eventFd, std::vector<char>& buffer) {
+    // Bytes still queued in the kernel tell how far behind the reader is
+    int pending = 0;
+    if (ioctl(eventFd, FIONREAD, &pending) == 0 && pending > 0) {
+        m_queueDepth = static_cast<size_t>(pending);
+        if (m_queueDepth > m_peakQueueDepth) {
+            m_peakQueueDepth = m_queueDepth.load();
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    size_t drained = 0;
+    
+    // The fd is non-blocking, so keep reading until the queue is empty
+    while (m_running) {
+        ssize_t length = read(eventFd, buffer.data(), buffer.size());
+        if (length <= 0) {
+            if (length == -1 && errno == EINTR) continue;
+            break; // EAGAIN: drained
+        }
+        
+        if (m_backend == WatchBackend::FANOTIFY) {
+            drained += handleFanotifyEvents(buffer.data(), static_cast<size_t>(length));
+        } else {
+            size_t offset = 0;
+            while (offset < static_cast<size_t>(length)) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer.data() + offset);
+                handleInotifyEvent(event);
+                offset += sizeof(struct inotify_event) + event->len;
+                drained++;
+            }
+        }
+    }
+    
+    resolveUnpairedMoves();
+    
+    m_queueDepth = 0;
+    m_eventsRead += drained;
+    m_lastDrainTime = std::chrono::system_clock::now();
+    
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (drained > 0 && elapsed > 0.0) {
+        m_drainRate = drained / elapsed;
+    }
+}
+
 void FileWatcher::setupInotify() {
-    m_inotify = inotify_init();
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
     if (m_inotify == -1) {
         throw std::runtime_error("Failed to initialize inotify");
     }
-    
-    // Add root directory to inotify
-    inotify_add_watch(m_inotify, m_rootPath.c_str(), 
-                      IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO);
 }
 
 void FileWatcher::cleanupInotify() {
@@ -290,39 +944,597 @@ void FileWatcher::cleanupInotify() {
         close(m_inotify);
         m_inotify = -1;
     }
+    
+    m_watchDirectories.clear();
+    m_directoryWatches.clear();
+}
+
+void FileWatcher::addDirectoryToInotify(const std::string& path) {
+    if (m_inotify == -1 || m_directoryWatches.count(path)) {
+        return;
+    }
+    
+    int wd = inotify_add_watch(m_inotify, path.c_str(), 
+                               IN_CREATE | IN_DELETE | IN_MODIFY | IN_MOVED_FROM | IN_MOVED_TO | 
+                               IN_DELETE_SELF | IN_ONLYDIR);
+    if (wd == -1) {
+        if (errno == ENOSPC) {
+            std::cerr << "⚠️  inotify watch limit reached at " << path 
+                      << " (raise fs.inotify.max_user_watches)\n";
+        }
+        return;
+    }
+    
+    // A directory renamed back into place keeps its old wd
+    auto existing = m_watchDirectories.find(wd);
+    if (existing != m_watchDirectories.end()) {
+        m_directoryWatches.erase(existing->second);
+    }
+    
+    m_watchDirectories[wd] = path;
+    m_directoryWatches[path] = wd;
+    m_watchedDirectoryCount = m_watchDirectories.size();
 }
 
-void FileWatcher::addFileToInotify(const std::string& path) {
-    inotify_add_watch(m_inotify, path.c_str(), IN_MODIFY | IN_DELETE);
+void FileWatcher::removeWatchDescriptor(int wd) {
+    auto it = m_watchDirectories.find(wd);
+    if (it == m_watchDirectories.end()) {
+        return;
+    }
+    
+    m_directoryWatches.erase(it->second);
+    m_watchDirectories.erase(it);
+    m_watchedDirectoryCount = m_watchDirectories.size();
 }
 
-#else
-void FileWatcher::pollForChanges() {
-    auto now = std::chrono::system_clock::now();
+void FileWatcher::handleInotifyEvent(const struct inotify_event* event) {
+    if (event->mask & IN_Q_OVERFLOW) {
+        rescanAfterOverflow();
+        return;
+    }
     
-    try {
+    // The kernel drops the watch after IN_DELETE_SELF or an unmount
+    if (event->mask & IN_IGNORED) {
         std::lock_guard<std::mutex> lock(m_stateMutex);
+        removeWatchDescriptor(event->wd);
+        return;
+    }
+    
+    if (event->len == 0) {
+        return;
+    }
+    
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        auto dir = m_watchDirectories.find(event->wd);
+        if (dir == m_watchDirectories.end()) {
+            m_eventsDropped++;
+            return;
+        }
+        path = dir->second + "/" + event->name;
+    }
+    
+    bool isDirectory = event->mask & IN_ISDIR;
+    
+    // A rename inside the tree arrives as MOVED_FROM/MOVED_TO sharing a cookie
+    if (event->mask & IN_MOVED_FROM) {
+        m_pendingMoves[event->cookie] = {path, isDirectory};
+        return;
+    }
+    
+    if (event->mask & IN_MOVED_TO) {
+        auto from = m_pendingMoves.find(event->cookie);
+        if (from != m_pendingMoves.end()) {
+            std::string oldPath = std::move(from->second.path);
+            m_pendingMoves.erase(from);
+            
+            if (isDirectory) {
+                handleDirectoryMove(oldPath, path);
+            } else {
+                handleFileMove(oldPath, path);
+            }
+            return;
+        }
         
+        // Moved in from outside the watched tree
+        if (isDirectory) {
+            scanDirectory(path, true);
+        } else {
+            handleFileChange(path, FileEvent::CREATED);
+        }
+        return;
+    }
+    
+    if (isDirectory) {
+        // New subtrees get their own watches; deleted ones are cleaned up via IN_IGNORED
+        if (event->mask & IN_CREATE) {
+            scanDirectory(path, true);
+        }
+        return;
+    }
+    
+    if (event->mask & IN_MODIFY) {
+        handleFileChange(path, FileEvent::MODIFIED);
+    } else if (event->mask & IN_CREATE) {
+        handleFileChange(path, FileEvent::CREATED);
+    } else if (event->mask & IN_DELETE) {
+        handleFileChange(path, FileEvent::DELETED);
+    }
+}
+
+void FileWatcher::resolveUnpairedMoves() {
+    // Both halves of a rename are queued together, so after a full drain a lone
+    // MOVED_FROM means the entry left the watched tree
+    auto unpaired = std::move(m_pendingMoves);
+    m_pendingMoves.clear();
+    
+    for (const auto& entry : unpaired) {
+        if (entry.second.isDirectory) {
+            handleDirectoryRemoved(entry.second.path);
+        } else {
+            handleFileChange(entry.second.path, FileEvent::DELETED);
+        }
+    }
+}
+
+void FileWatcher::rescanAfterOverflow() {
+    m_overflowCount++;
+    std::cerr << "⚠️  " << getBackendName() << " queue overflowed, rescanning " << m_rootPath << "\n";
+    
+    // Anything written after the last complete drain may have lost its event
+    auto cutoff = m_lastDrainTime;
+    std::vector<std::string> deleted;
+    std::vector<std::string> modified;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
         for (const auto& filePath : m_watchedFiles) {
-            if (std::filesystem::exists(filePath)) {
-                auto lastModified = std::filesystem::last_write_time(filePath);
-                // Convert to system_clock time point for comparison
-                auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-                    lastModified - std::filesystem::file_time_type::clock::now() + now
-                );
-                
-                if (sctp > m_lastScan) {
-                    handleFileChange(filePath, FileEvent::MODIFIED);
+            std::error_code ec;
+            auto lastModified = std::filesystem::last_write_time(filePath, ec);
+            if (ec) {
+                deleted.push_back(filePath);
+                continue;
+            }
+            
+            auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+                lastModified - std::filesystem::file_time_type::clock::now() + 
+                std::chrono::system_clock::now());
+            if (sctp >= cutoff) {
+                modified.push_back(filePath);
+            }
+        }
+    }
+    
+    for (const auto& filePath : deleted) {
+        handleFileChange(filePath, FileEvent::DELETED);
+    }
+    for (const auto& filePath : modified) {
+        handleFileChange(filePath, FileEvent::MODIFIED);
+    }
+    
+    // Re-walk the tree to pick up missed directories and new files
+    scanDirectory(m_rootPath, true);
+}
+
+bool FileWatcher::setupFanotify() {
+    std::error_code ec;
+    m_canonicalRoot = std::filesystem::canonical(m_rootPath, ec).string();
+    if (ec) {
+        return false;
+    }
+    
+    m_fanotify = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK | FAN_REPORT_DFID_NAME, 
+                               O_RDONLY | O_LARGEFILE);
+    if (m_fanotify == -1) {
+        std::cerr << "⚠️  fanotify unavailable (" << std::strerror(errno) << "), falling back to inotify\n";
+        return false;
+    }
+    
+    // Directory handles are resolved back to paths relative to this mount
+    m_mountFd = open(m_canonicalRoot.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    
+    // FAN_RENAME (Linux 5.17+) reports both ends of a rename in one event;
+    // older kernels reject it and get unpaired MOVED_FROM/MOVED_TO instead
+    uint64_t mask = FAN_CREATE | FAN_DELETE | FAN_MODIFY | FAN_RENAME | FAN_ONDIR;
+    unsigned int markFlags = FAN_MARK_ADD | FAN_MARK_FILESYSTEM;
+    int marked = -1;
+    if (m_mountFd != -1) {
+        marked = fanotify_mark(m_fanotify, markFlags, mask, AT_FDCWD, m_canonicalRoot.c_str());
+        if (marked == -1 && errno == EINVAL) {
+            mask = (mask & ~static_cast<uint64_t>(FAN_RENAME)) | FAN_MOVED_FROM | FAN_MOVED_TO;
+            marked = fanotify_mark(m_fanotify, markFlags, mask, AT_FDCWD, m_canonicalRoot.c_str());
+        }
+    }
+    
+    if (marked == -1) {
+        std::cerr << "⚠️  fanotify filesystem mark failed (" << std::strerror(errno) 
+                  << "), falling back to inotify\n";
+        cleanupFanotify();
+        return false;
+    }
+    
+    return true;
+}
+
+void FileWatcher::cleanupFanotify() {
+    if (m_fanotify != -1) {
+        close(m_fanotify);
+        m_fanotify = -1;
+    }
+    if (m_mountFd != -1) {
+        close(m_mountFd);
+        m_mountFd = -1;
+    }
+    
+    m_handlePaths.clear();
+}
+
+size_t FileWatcher::handleFanotifyEvents(char* buffer, size_t length) {
+    auto* metadata = reinterpret_cast<struct fanotify_event_metadata*>(buffer);
+    size_t count = 0;
+    
+    for (; FAN_EVENT_OK(metadata, length); metadata = FAN_EVENT_NEXT(metadata, length)) {
+        count++;
+        if (metadata->vers != FANOTIFY_METADATA_VERSION) {
+            continue;
+        }
+        if (metadata->fd >= 0) {
+            close(metadata->fd);
+        }
+        
+        if (metadata->mask & FAN_Q_OVERFLOW) {
+            rescanAfterOverflow();
+            continue;
+        }
+        
+        // Walk the info records: DFID_NAME for most events, OLD/NEW_DFID_NAME for FAN_RENAME
+        const struct fanotify_event_info_fid* entry = nullptr;
+        const struct fanotify_event_info_fid* renamedFrom = nullptr;
+        const struct fanotify_event_info_fid* renamedTo = nullptr;
+        
+        const char* info = reinterpret_cast<const char*>(metadata) + metadata->metadata_len;
+        const char* end = reinterpret_cast<const char*>(metadata) + metadata->event_len;
+        while (info + sizeof(struct fanotify_event_info_header) <= end) {
+            auto* header = reinterpret_cast<const struct fanotify_event_info_header*>(info);
+            if (header->len == 0 || info + header->len > end) {
+                break;
+            }
+            
+            auto* fid = reinterpret_cast<const struct fanotify_event_info_fid*>(info);
+            if (header->info_type == FAN_EVENT_INFO_TYPE_DFID_NAME) {
+                entry = fid;
+            } else if (header->info_type == FAN_EVENT_INFO_TYPE_OLD_DFID_NAME) {
+                renamedFrom = fid;
+            } else if (header->info_type == FAN_EVENT_INFO_TYPE_NEW_DFID_NAME) {
+                renamedTo = fid;
+            }
+            info += header->len;
+        }
+        
+        bool isDirectory = metadata->mask & FAN_ONDIR;
+        
+        if (metadata->mask & FAN_RENAME) {
+            // Resolve before dropping cached handles; the parents themselves did not move
+            std::string oldPath = renamedFrom ? resolveFanotifyPath(renamedFrom) : "";
+            std::string newPath = renamedTo ? resolveFanotifyPath(renamedTo) : "";
+            if (isDirectory) {
+                m_handlePaths.clear();
+            }
+            
+            if (!oldPath.empty() && !newPath.empty()) {
+                if (isDirectory) {
+                    handleDirectoryMove(oldPath, newPath);
+                } else {
+                    handleFileMove(oldPath, newPath);
+                }
+            } else if (!newPath.empty()) {
+                if (isDirectory) {
+                    scanDirectory(newPath, true);
+                } else {
+                    handleFileChange(newPath, FileEvent::CREATED);
+                }
+            } else if (!oldPath.empty()) {
+                if (isDirectory) {
+                    handleDirectoryRemoved(oldPath);
+                } else {
+                    handleFileChange(oldPath, FileEvent::DELETED);
                 }
-            } else {
-                handleFileChange(filePath, FileEvent::DELETED);
             }
+            continue;
         }
         
-        m_lastScan = now;
+        if (!entry) {
+            continue;
+        }
         
-    } catch (const std::exception& e) {
-        std::cerr << "❌ Error polling for changes: " << e.what() << "\n";
+        std::string path = resolveFanotifyPath(entry);
+        
+        // Without FAN_RENAME a directory move arrives as unpaired MOVED_FROM /
+        // MOVED_TO, so the files inside are reported as deleted and recreated.
+        // Renamed or deleted directories also invalidate cached handle paths
+        if (isDirectory) {
+            if (metadata->mask & (FAN_MOVED_FROM | FAN_MOVED_TO | FAN_DELETE)) {
+                m_handlePaths.clear();
+            }
+            if (path.empty()) {
+                continue;
+            }
+            if (metadata->mask & (FAN_DELETE | FAN_MOVED_FROM)) {
+                handleDirectoryRemoved(path);
+            } else if (metadata->mask & (FAN_CREATE | FAN_MOVED_TO)) {
+                scanDirectory(path, true);
+            }
+            continue;
+        }
+        
+        if (path.empty()) {
+            continue;
+        }
+        
+        // fanotify merges queued events on the same file, so CREATE|MODIFY arrives as one
+        if (metadata->mask & (FAN_DELETE | FAN_MOVED_FROM)) {
+            handleFileChange(path, FileEvent::DELETED);
+        } else if (metadata->mask & (FAN_CREATE | FAN_MOVED_TO)) {
+            handleFileChange(path, FileEvent::CREATED);
+        } else if (metadata->mask & FAN_MODIFY) {
+            handleFileChange(path, FileEvent::MODIFIED);
+        }
+    }
+    
+    return count;
+}
+
+std::string FileWatcher::resolveFanotifyPath(const struct fanotify_event_info_fid* fid) {
+    auto* handle = reinterpret_cast<const struct file_handle*>(fid->handle);
+    const char* name = reinterpret_cast<const char*>(handle->f_handle) + handle->handle_bytes;
+    
+    std::string directory = resolveDirectoryHandle(&fid->fsid, handle);
+    if (directory.empty()) {
+        m_eventsDropped++;
+        return "";
+    }
+    
+    // The mark covers the whole filesystem; keep only events under the root
+    if (directory.compare(0, m_canonicalRoot.size(), m_canonicalRoot) != 0 ||
+        (directory.size() > m_canonicalRoot.size() && directory[m_canonicalRoot.size()] != '/')) {
+        return "";
+    }
+    
+    return m_rootPath + directory.substr(m_canonicalRoot.size()) + "/" + name;
+}
+
+std::string FileWatcher::resolveDirectoryHandle(const void* fsid, const struct file_handle* handle) {
+    std::string key(static_cast<const char*>(fsid), sizeof(__kernel_fsid_t));
+    key.append(reinterpret_cast<const char*>(&handle->handle_type), sizeof(handle->handle_type));
+    key.append(reinterpret_cast<const char*>(handle->f_handle), handle->handle_bytes);
+    
+    auto cached = m_handlePaths.find(key);
+    if (cached != m_handlePaths.end()) {
+        return cached->second;
+    }
+    
+    int fd = open_by_handle_at(m_mountFd, const_cast<struct file_handle*>(handle), O_RDONLY | O_PATH);
+    if (fd == -1) {
+        return "";
+    }
+    
+    char target[PATH_MAX];
+    std::string procPath = "/proc/self/fd/" + std::to_string(fd);
+    ssize_t length = readlink(procPath.c_str(), target, sizeof(target) - 1);
+    close(fd);
+    if (length <= 0) {
+        return "";
+    }
+    
+    std::string directory(target, static_cast<size_t>(length));
+    m_handlePaths.emplace(std::move(key), directory);
+    return directory;
+}
+
+#endif
+
+void FileWatcher::pollLoop() {
+    auto nextPoll = std::chrono::steady_clock::now();
+    
+    while (m_running) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextPoll) {
+            pollForChanges();
+            nextPoll = now + m_pollInterval;
+        }
+        
+        flushDebounced();
+        
+        auto untilPoll = std::chrono::duration_cast<std::chrono::milliseconds>(
+            nextPoll - std::chrono::steady_clock::now());
+        waitForWakeup(std::max(std::chrono::milliseconds(0), std::min(untilPoll, nextWakeup())));
+    }
+}
+
+void FileWatcher::waitForWakeup(std::chrono::milliseconds timeout) {
+#ifdef __linux__
+    // Returns early when stopWatching signals the eventfd
+    struct epoll_event ready;
+    epoll_wait(m_epoll, &ready, 1, static_cast<int>(timeout.count()));
+#else
+    std::this_thread::sleep_for(std::min(timeout, std::chrono::milliseconds(100)));
+#endif
+}
+
+void FileWatcher::pollForChanges() {
+    auto deadline = std::chrono::steady_clock::now() + m_pollBudget;
+    size_t visited = 0;
+    size_t total = m_pollOrder.size();
+    
+    // Resume where the last cycle ran out of budget; a full lap may span many cycles
+    while (m_running && visited < total && std::chrono::steady_clock::now() < deadline) {
+        if (m_pollCursor >= m_pollOrder.size()) {
+            m_pollCursor = 0;
+            m_pollLap++;
+            
+            // Drop directories removed since the last lap
+            m_pollOrder.erase(std::remove_if(m_pollOrder.begin(), m_pollOrder.end(),
+                [this](const std::string& path) { return !m_polledDirectories.count(path); }),
+                m_pollOrder.end());
+            if (m_pollOrder.empty()) {
+                break;
+            }
+        }
+        
+        std::string path = m_pollOrder[m_pollCursor++];
+        visited++;
+        
+        auto it = m_polledDirectories.find(path);
+        if (it != m_polledDirectories.end()) {
+            pollDirectory(path, it->second);
+        }
+    }
+}
+
+void FileWatcher::pollDirectory(const std::string& path, PolledDirectory& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    
+    auto stampOf = [&ec](const fs::path& filePath) {
+        FileStamp stamp{fs::last_write_time(filePath, ec).time_since_epoch().count(), 0};
+        stamp.size = ec ? 0 : fs::file_size(filePath, ec);
+        return stamp;
+    };
+    
+    int64_t mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+    if (ec) {
+        removePolledDirectory(path);
+        return;
+    }
+    
+    std::vector<std::string> modified;
+    
+    // Unchanged listing: only in-place writes remain to be found, and those are
+    // only looked for on verification laps
+    if (directory.initialized && mtime == directory.mtime) {
+        if (m_pollLap % POLL_VERIFY_LAPS != 0) {
+            return;
+        }
+        for (auto& file : directory.files) {
+            FileStamp stamp = stampOf(file.first);
+            if (!ec && stamp != file.second) {
+                file.second = stamp;
+                modified.push_back(file.first);
+            }
+        }
+        
+        for (const auto& filePath : modified) {
+            handleFileChange(filePath, FileEvent::MODIFIED);
+        }
+        return;
+    }
+    
+    std::vector<std::string> created;
+    std::vector<std::string> deleted;
+    std::vector<std::string> newDirectories;
+    std::unordered_set<std::string> seenFiles;
+    std::unordered_set<std::string> seenDirectories;
+    
+    for (const auto& entry : fs::directory_iterator(path, fs::directory_options::skip_permission_denied, ec)) {
+        std::string entryPath = entry.path().string();
+        std::error_code typeError;
+        
+        if (entry.is_directory(typeError)) {
+            seenDirectories.insert(entryPath);
+            if (!m_polledDirectories.count(entryPath)) {
+                newDirectories.push_back(entryPath);
+            }
+            continue;
+        }
+        
+        if (!entry.is_regular_file(typeError) || !isFileRelevant(entryPath)) {
+            continue;
+        }
+        
+        seenFiles.insert(entryPath);
+        FileStamp stamp = stampOf(entry.path());
+        auto known = directory.files.find(entryPath);
+        
+        if (known == directory.files.end()) {
+            directory.files.emplace(entryPath, stamp);
+            
+            // The first visit only records what the initial scan already reported
+            bool reported = false;
+            if (!directory.initialized) {
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                reported = m_watchedFiles.count(entryPath) > 0;
+            }
+            if (!reported) {
+                created.push_back(entryPath);
+            }
+        } else if (stamp != known->second) {
+            known->second = stamp;
+            modified.push_back(entryPath);
+        }
+    }
+    
+    for (auto it = directory.files.begin(); it != directory.files.end();) {
+        if (!seenFiles.count(it->first)) {
+            deleted.push_back(it->first);
+            it = directory.files.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    std::vector<std::string> removedDirectories;
+    for (const auto& subdirectory : directory.subdirectories) {
+        if (!seenDirectories.count(subdirectory)) {
+            removedDirectories.push_back(subdirectory);
+        }
+    }
+    
+    directory.mtime = mtime;
+    directory.subdirectories = std::move(seenDirectories);
+    directory.initialized = true;
+    
+    for (const auto& filePath : created) {
+        handleFileChange(filePath, FileEvent::CREATED);
+    }
+    for (const auto& filePath : modified) {
+        handleFileChange(filePath, FileEvent::MODIFIED);
+    }
+    for (const auto& filePath : deleted) {
+        handleFileChange(filePath, FileEvent::DELETED);
+    }
+    for (const auto& subdirectory : removedDirectories) {
+        removePolledDirectory(subdirectory);
+    }
+    for (const auto& subdirectory : newDirectories) {
+        scanDirectory(subdirectory, true);
+    }
+}
+
+void FileWatcher::trackPolledDirectory(const std::string& path) {
+    if (m_polledDirectories.emplace(path, PolledDirectory()).second) {
+        m_pollOrder.push_back(path);
+        m_watchedDirectoryCount = m_polledDirectories.size();
+    }
+}
+
+void FileWatcher::removePolledDirectory(const std::string& path) {
+    std::string prefix = path + "/";
+    std::vector<std::string> deleted;
+    
+    for (auto it = m_polledDirectories.begin(); it != m_polledDirectories.end();) {
+        if (it->first == path || it->first.compare(0, prefix.size(), prefix) == 0) {
+            for (const auto& file : it->second.files) {
+                deleted.push_back(file.first);
+            }
+            it = m_polledDirectories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_watchedDirectoryCount = m_polledDirectories.size();
+    
+    for (const auto& filePath : deleted) {
+        handleFileChange(filePath, FileEvent::DELETED);
     }
 }
-#endif 
\ No newline at end of file
@@ -7,8 +7,13 @@
 #include <thread>
 #include <atomic>
 #include <unordered_set>
+#include <unordered_map>
 #include <chrono>
 #include <mutex>
+#include <cstdint>
+#include <memory>
+#include "LatencyHistogram.hpp"
+#include "ExtensionSet.hpp"
 
 enum class FileEvent {
     CREATED,
@@ -17,24 +22,111 @@ enum class FileEvent {
     MOVED
 };
 
+enum class WatchBackend {
+    INOTIFY,
+    FANOTIFY,
+    KQUEUE,
+    POLLING
+};
+
 struct FileChange {
     std::string path;
     FileEvent event;
     std::chrono::system_clock::time_point timestamp;
+    std::string oldPath; // MOVED only: where the file was before
     
     FileChange(const std::string& p, FileEvent e) 
         : path(p), event(e), timestamp(std::chrono::system_clock::now()) {}
+    
+    FileChange(const std::string& from, const std::string& to)
+        : path(to), event(FileEvent::MOVED), timestamp(std::chrono::system_clock::now()), oldPath(from) {}
+};
+
+// Coalesces raw events per path and releases each path once it has been quiet
+// for the debounce window. Deadlines sit in a timer wheel of fixed-width slots,
+// so scheduling and expiry are O(1) per event regardless of pending count.
+class ChangeDebouncer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    explicit ChangeDebouncer(std::chrono::milliseconds window = std::chrono::milliseconds(100),
+                             std::chrono::milliseconds tick = std::chrono::milliseconds(10));
+    
+    void setWindow(std::chrono::milliseconds window);
+    std::chrono::milliseconds getTick() const;
+    
+    // Record a raw event; repeated events on a path push its deadline back
+    void add(const std::string& path, FileEvent event, Clock::time_point now);
+    
+    // Record a rename; pending state of the old path follows the file
+    void addMove(const std::string& oldPath, const std::string& newPath, Clock::time_point now);
+    
+    // Net changes for every path whose window has elapsed
+    std::vector<FileChange> collectReady(Clock::time_point now);
+    std::vector<FileChange> flushAll();
+    
+    bool hasPending() const;
+    size_t getPendingCount() const;
+    size_t getCoalescedCount() const;
+    
+private:
+    struct PendingChange {
+        bool existedBefore;   // first event was not a create
+        bool existsNow;       // last event was not a delete
+        bool modifiedAfterMove;
+        std::string movedFrom;  // original path when the file was renamed in the window
+        uint64_t deadlineTick;
+        std::chrono::system_clock::time_point firstSeen;
+    };
+    
+    std::chrono::milliseconds m_window;
+    std::chrono::milliseconds m_tick;
+    std::unordered_map<std::string, PendingChange> m_pending;
+    std::vector<std::vector<std::string>> m_wheel;  // slot -> paths due in that tick
+    Clock::time_point m_epoch;
+    uint64_t m_nextTick;
+    std::atomic<size_t> m_coalescedCount;
+    
+    uint64_t tickFor(Clock::time_point time) const;
+    void expireSlot(size_t slot, uint64_t nowTick, std::vector<FileChange>& ready);
+    void appendNetChange(const std::string& path, const PendingChange& pending, 
+                         std::vector<FileChange>& ready) const;
+};
+
+// Point-in-time copy of the watcher counters, safe to read from any thread
+struct WatcherStats {
+    WatchBackend backend;
+    size_t watches;             // kernel watches or marks installed (polled directories when polling)
+    size_t watchedFiles;
+    size_t watchedDirectories;
+    size_t eventsRead;          // raw records read from the kernel queue
+    size_t eventsCoalesced;     // raw changes folded into another pending change
+    size_t eventsDropped;       // records that could not be mapped back to a path
+    size_t eventsDelivered;     // debounced changes handed to the callbacks
+    size_t overflows;           // kernel queue overflows, each followed by a rescan
+    size_t queueDepth;
+    size_t peakQueueDepth;
+    double drainRate;
+    
+    // From the first event read for a path until its debounced change reaches
+    // the callbacks; includes the debounce window
+    LatencyHistogram deliveryLatency;
 };
 
+class WatchJournal;
+class ThreadPool;
+
 class FileWatcher {
 public:
     using ChangeCallback = std::function<void(const FileChange&)>;
+    using BatchCallback = std::function<void(const std::vector<FileChange>&)>;
     
     FileWatcher();
     ~FileWatcher();
     
     // Start watching a directory tree
     bool startWatching(const std::string& rootPath, const std::vector<std::string>& extensions);
+    bool startWatching(const std::string& rootPath, const ExtensionSet& extensions);
     
     // Stop watching
     void stopWatching();
@@ -42,32 +134,86 @@ public:
     // Set callback for file changes
     void setChangeCallback(ChangeCallback callback);
     
+    // Set callback receiving each flushed group of debounced changes at once
+    void setBatchCallback(BatchCallback callback);
+    
     // Check if currently watching
     bool isWatching() const;
     
     // Get statistics
     size_t getWatchedFileCount() const;
+    size_t getWatchedDirectoryCount() const;
     size_t getChangeEventCount() const;
     
-    // Performance settings
+    // Event queue counters: raw events read, kernel queue backlog in bytes
+    // seen at the start of a drain, and events/second of the last drain
+    size_t getEventsRead() const;
+    size_t getQueueDepth() const;
+    size_t getPeakQueueDepth() const;
+    double getDrainRate() const;
+    
+    // All counters plus the delivery latency histogram in one snapshot
+    WatcherStats getStats() const;
+    
+    // Active event source, chosen when watching starts
+    WatchBackend getBackend() const;
+    std::string getBackendName() const;
+    
+    // Performance settings (debounce time must be set before startWatching)
     void setDebounceTime(std::chrono::milliseconds ms);
     void setMaxEvents(size_t maxEvents);
     
+    // Use one fanotify filesystem mark instead of per-directory inotify watches.
+    // Linux only; needs CAP_SYS_ADMIN and falls back to inotify without it
+    void setUseFanotify(bool enabled);
+    
+    // Poll instead of using kernel notifications, for filesystems that never
+    // deliver them. Each poll cycle spends at most the budget stat'ing entries
+    void setUsePolling(bool enabled);
+    void setPollInterval(std::chrono::milliseconds interval);
+    void setPollBudget(std::chrono::milliseconds budget);
+    
+    // Keep a journal of delivered changes in this directory (empty disables it).
+    // On the next start, changes made while the watcher was down are replayed
+    // through the callbacks instead of requiring a full rescan by the caller.
+    // The startup stat walk runs on statPool, which must outlive the watcher
+    void setJournalDirectory(const std::string& directory, ThreadPool& statPool);
+    
 private:
     std::atomic<bool> m_running;
     std::atomic<bool> m_watching;
     std::thread m_watchThread;
     std::string m_rootPath;
-    std::vector<std::string> m_extensions;
+    ExtensionSet m_extensions;
     ChangeCallback m_callback;
+    BatchCallback m_batchCallback;
+    std::atomic<WatchBackend> m_backend;
+    bool m_useFanotify;
+    bool m_usePolling;
+    std::chrono::milliseconds m_pollInterval;
+    std::chrono::milliseconds m_pollBudget;
     
     // Statistics
     std::atomic<size_t> m_watchedFileCount;
+    std::atomic<size_t> m_watchedDirectoryCount;
     std::atomic<size_t> m_changeEventCount;
+    std::atomic<size_t> m_eventsRead;
+    std::atomic<size_t> m_queueDepth;
+    std::atomic<size_t> m_peakQueueDepth;
+    std::atomic<double> m_drainRate;
+    std::atomic<size_t> m_eventsDropped;
+    std::atomic<size_t> m_eventsDelivered;
+    std::atomic<size_t> m_overflowCount;
+    LatencyHistogram m_deliveryLatency;
+    mutable std::mutex m_statsMutex;
     
     // Performance settings
     std::chrono::milliseconds m_debounceTime;
     size_t m_maxEvents;
+    ChangeDebouncer m_debouncer;
+    std::string m_journalDirectory;
+    std::unique_ptr<WatchJournal> m_journal;
+    ThreadPool* m_statPool;
     
     // Internal state
     std::mutex m_stateMutex;
@@ -77,7 +223,12 @@ private:
     void watchLoop();
     bool isFileRelevant(const std::string& path) const;
     void handleFileChange(const std::string& path, FileEvent event);
-    void debounceAndNotify(const FileChange& change);
+    void handleFileMove(const std::string& oldPath, const std::string& newPath);
+    void handleDirectoryMove(const std::string& oldPath, const std::string& newPath);
+    void handleDirectoryRemoved(const std::string& path);
+    void flushDebounced(bool force = false);
+    void openJournal();
+    std::chrono::milliseconds nextWakeup() const;
     
 #ifdef __APPLE__
     // macOS kqueue implementation
@@ -87,20 +238,77 @@ private:
     void addFileToKqueue(const std::string& path);
     void removeFileFromKqueue(const std::string& path);
 #elif __linux__
-    // Linux inotify implementation
+    // Linux inotify implementation: one watch per directory. Event names are
+    // relative to their watch, so wd -> directory resolves them to full paths
     int m_inotify;
+    std::unordered_map<int, std::string> m_watchDirectories;  // wd -> directory
+    std::unordered_map<std::string, int> m_directoryWatches;  // directory -> wd
+    std::chrono::system_clock::time_point m_lastDrainTime;
     void setupInotify();
     void cleanupInotify();
-    void addFileToInotify(const std::string& path);
-#else
-    // Fallback polling implementation
-    std::chrono::system_clock::time_point m_lastScan;
-    void pollForChanges();
+    void addDirectoryToInotify(const std::string& path);
+    void removeWatchDescriptor(int wd);
+    void handleInotifyEvent(const struct inotify_event* event);
+    void rescanAfterOverflow();
+    
+    // IN_MOVED_FROM halves waiting for the IN_MOVED_TO with the same cookie
+    struct PendingMove {
+        std::string path;
+        bool isDirectory;
+    };
+    std::unordered_map<uint32_t, PendingMove> m_pendingMoves;
+    void resolveUnpairedMoves();
+    
+    // epoll over the active event fd plus an eventfd that stopWatching signals
+    int m_epoll;
+    int m_wakeFd;
+    void setupEpoll(int eventFd);
+    void cleanupEpoll();
+    void drainEvents(int eventFd, std::vector<char>& buffer);
+    
+    // Linux fanotify implementation: a single filesystem mark reporting directory
+    // handle + name, filtered down to the watched root in user space
+    int m_fanotify;
+    int m_mountFd;
+    std::string m_canonicalRoot;
+    std::unordered_map<std::string, std::string> m_handlePaths;  // directory handle -> path
+    bool setupFanotify();
+    void cleanupFanotify();
+    size_t handleFanotifyEvents(char* buffer, size_t length);
+    std::string resolveFanotifyPath(const struct fanotify_event_info_fid* fid);
+    std::string resolveDirectoryHandle(const void* fsid, const struct file_handle* handle);
 #endif
 
+    // Polling implementation, used where no native backend exists or when forced
+    // (e.g. network filesystems). A changed directory mtime reveals adds, removes
+    // and renames, and only then are its files stat'ed; each cycle visits
+    // directories round-robin within a time budget. In-place writes leave the
+    // directory mtime alone, so every POLL_VERIFY_LAPS-th lap stats all files
+    static constexpr size_t POLL_VERIFY_LAPS = 16;
+    struct FileStamp {
+        int64_t mtime;
+        uintmax_t size;
+        bool operator!=(const FileStamp& other) const { return mtime != other.mtime || size != other.size; }
+    };
+    struct PolledDirectory {
+        bool initialized = false;
+        int64_t mtime = 0;
+        std::unordered_map<std::string, FileStamp> files;  // relevant files by full path
+        std::unordered_set<std::string> subdirectories;
+    };
+    std::unordered_map<std::string, PolledDirectory> m_polledDirectories;
+    std::vector<std::string> m_pollOrder;
+    size_t m_pollCursor;
+    size_t m_pollLap;
+    void pollLoop();
+    void pollForChanges();
+    void pollDirectory(const std::string& path, PolledDirectory& directory);
+    void trackPolledDirectory(const std::string& path);
+    void removePolledDirectory(const std::string& path);
+    void waitForWakeup(std::chrono::milliseconds timeout);
+
     // Utility functions
-    void scanDirectory(const std::string& path);
-    std::string getFileExtension(const std::string& path) const;
+    void scanDirectory(const std::string& path, bool notifyNewFiles = false);
 };
 
 #endif // FILEWATCHER_HPP 
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "IdentifierIndex.hpp"
+#include <algorithm>
+
+namespace {
+
+// UTF-16 code units taken by the character starting with this byte;
+// continuation bytes take none
+uint32_t utf16Width(unsigned char c) {
+    if ((c & 0xC0) == 0x80) {
+        return 0;
+    }
+    return c >= 0xF0 ? 2 : 1;
+}
+
+} // namespace
+
+IdentifierIndex::FileTokens IdentifierIndex::tokenize(const std::string& text) {
+    struct Pending {
+        std::string bytes;
+        uint32_t line;
+        uint32_t character;
+    };
+    std::unordered_map<std::string_view, Pending> pending;
+
+    uint32_t line = 0;
+    uint32_t character = 0;
+    size_t i = 0;
+    const size_t size = text.size();
+
+    while (i < size) {
+        char c = text[i];
+        if (c == '\n') {
+            line++;
+            character = 0;
+            i++;
+            continue;
+        }
+
+        if (c >= '0' && c <= '9') {
+            // Numbers, including suffixes and hex digits, are not identifiers
+            while (i < size && (isIdentifierChar(text[i]) || text[i] == '.')) {
+                i++;
+                character++;
+            }
+            continue;
+        }
+
+        if (!isIdentifierStart(c)) {
+            character += utf16Width(static_cast<unsigned char>(c));
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < size && isIdentifierChar(text[i])) {
+            i++;
+        }
+        std::string_view token(text.data() + start, i - start);
+
+        auto inserted = pending.emplace(token, Pending{std::string(), 0, 0});
+        Pending& postings = inserted.first->second;
+        uint32_t lineDelta = line - postings.line;
+        appendVarint(postings.bytes, lineDelta);
+        appendVarint(postings.bytes, lineDelta > 0 ? character : character - postings.character);
+        postings.line = line;
+        postings.character = character;
+
+        character += static_cast<uint32_t>(i - start);
+    }
+
+    FileTokens tokens;
+    tokens.reserve(pending.size());
+    for (auto& entry : pending) {
+        tokens.emplace_back(std::string(entry.first), std::move(entry.second.bytes));
+    }
+    return tokens;
+}
+
+void IdentifierIndex::updateFile(const std::string& filePath, const FileTokens& tokens) {
+    uint32_t file = fileIdFor(filePath);
+    removeFile(file);
+
+    std::vector<FileToken>& fileTokens = m_fileTokens[file];
+    fileTokens.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        auto inserted = m_tokenIds.emplace(token.first, static_cast<uint32_t>(m_tokens.size()));
+        if (inserted.second) {
+            m_tokens.push_back(token.first);
+            m_postings.emplace_back();
+        }
+
+        uint32_t id = inserted.first->second;
+        auto& list = m_postings[id];
+        fileTokens.push_back({id, static_cast<uint32_t>(list.size())});
+        list.push_back({file, static_cast<uint32_t>(fileTokens.size() - 1), token.second});
+        m_postingBytes += token.second.size();
+    }
+}
+
+void IdentifierIndex::clear() {
+    m_tokenIds.clear();
+    m_tokens.clear();
+    m_postings.clear();
+    m_fileIds.clear();
+    m_filePaths.clear();
+    m_fileTokens.clear();
+    m_postingBytes = 0;
+}
+
+std::vector<IdentifierIndex::Location> IdentifierIndex::find(const std::string& identifier, size_t limit,
+                                                             const CancellationToken* cancel) const {
+    std::vector<Location> locations;
+    auto token = m_tokenIds.find(identifier);
+    if (token == m_tokenIds.end()) {
+        return locations;
+    }
+
+    for (const Postings& postings : m_postings[token->second]) {
+        if (locations.size() >= limit || CancellationToken::isCancelled(cancel)) {
+            break;
+        }
+        decode(postings.bytes, [&](Occurrence occurrence) {
+            if (locations.size() < limit) {
+                locations.push_back({postings.file, occurrence});
+            }
+        });
+    }
+    return locations;
+}
+
+std::vector<IdentifierIndex::Occurrence> IdentifierIndex::findOnLine(const std::string& identifier,
+                                                                     const std::string& filePath,
+                                                                     uint32_t line) const {
+    std::vector<Occurrence> occurrences;
+    auto token = m_tokenIds.find(identifier);
+    auto file = m_fileIds.find(filePath);
+    if (token == m_tokenIds.end() || file == m_fileIds.end()) {
+        return occurrences;
+    }
+
+    for (const Postings& postings : m_postings[token->second]) {
+        if (postings.file == file->second) {
+            decode(postings.bytes, [&](Occurrence occurrence) {
+                if (occurrence.line == line) {
+                    occurrences.push_back(occurrence);
+                }
+            });
+            break;
+        }
+    }
+    return occurrences;
+}
+
+std::string IdentifierIndex::identifierAt(const std::string& line, int character, int& startCharacter) {
+    // UTF-16 character -> byte offset
+    size_t offset = 0;
+    int units = 0;
+    while (offset < line.size() && units < character) {
+        units += static_cast<int>(utf16Width(static_cast<unsigned char>(line[offset])));
+        offset++;
+        while (offset < line.size() && utf16Width(static_cast<unsigned char>(line[offset])) == 0) {
+            offset++;
+        }
+    }
+
+    // A cursor just past the end of a word still refers to it
+    if ((offset >= line.size() || !isIdentifierChar(line[offset])) && offset > 0 &&
+        isIdentifierChar(line[offset - 1])) {
+        offset--;
+    }
+    if (offset >= line.size() || !isIdentifierChar(line[offset])) {
+        return "";
+    }
+
+    size_t begin = offset;
+    while (begin > 0 && isIdentifierChar(line[begin - 1])) {
+        begin--;
+    }
+    size_t end = offset;
+    while (end < line.size() && isIdentifierChar(line[end])) {
+        end++;
+    }
+
+    // Skip leading digits the way tokenize does
+    if (!isIdentifierStart(line[begin])) {
+        return "";
+    }
+
+    startCharacter = 0;
+    for (size_t i = 0; i < begin; i++) {
+        startCharacter += static_cast<int>(utf16Width(static_cast<unsigned char>(line[i])));
+    }
+    return line.substr(begin, end - begin);
+}
+
+void IdentifierIndex::removeFile(uint32_t file) {
+    // Each list is swapped out with the token's last one, whose owner is
+    // told its new slot; no list is searched
+    for (const FileToken& entry : m_fileTokens[file]) {
+        auto& list = m_postings[entry.token];
+        m_postingBytes -= list[entry.slot].bytes.size();
+        if (entry.slot + 1 < list.size()) {
+            list[entry.slot] = std::move(list.back());
+            const Postings& moved = list[entry.slot];
+            m_fileTokens[moved.file][moved.fileSlot].slot = entry.slot;
+        }
+        list.pop_back();
+    }
+    m_fileTokens[file].clear();
+}
+
+uint32_t IdentifierIndex::fileIdFor(const std::string& filePath) {
+    auto inserted = m_fileIds.emplace(filePath, static_cast<uint32_t>(m_filePaths.size()));
+    if (inserted.second) {
+        m_filePaths.push_back(filePath);
+        m_fileTokens.emplace_back();
+    }
+    return inserted.first->second;
+}
+
+bool IdentifierIndex::isIdentifierStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '$';
+}
+
+bool IdentifierIndex::isIdentifierChar(char c) {
+    return isIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+void IdentifierIndex::appendVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+uint32_t IdentifierIndex::readVarint(const std::string& bytes, size_t& pos) {
+    uint32_t value = 0;
+    int shift = 0;
+    while (pos < bytes.size()) {
+        unsigned char byte = static_cast<unsigned char>(bytes[pos++]);
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+        shift += 7;
+    }
+    return value;
+}
+
+template <typename Visitor>
+void IdentifierIndex::decode(const std::string& bytes, Visitor visit) {
+    Occurrence occurrence{0, 0};
+    size_t pos = 0;
+    while (pos < bytes.size()) {
+        uint32_t lineDelta = readVarint(bytes, pos);
+        uint32_t character = readVarint(bytes, pos);
+        if (lineDelta > 0) {
+            occurrence.line += lineDelta;
+            occurrence.character = character;
+        } else {
+            occurrence.character += character;
+        }
+        visit(occurrence);
+    }
+}
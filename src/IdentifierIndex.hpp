@@ -0,0 +1,90 @@
+#ifndef IDENTIFIERINDEX_HPP
+#define IDENTIFIERINDEX_HPP
+
+#include "CancellationToken.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Inverted index of every identifier occurrence in the workspace, for
+// textDocument/references. Each (identifier, file) pair owns a postings list
+// of (line, character) positions, delta-encoded and packed as varints:
+// the line delta, then the character (as a delta when the line repeats).
+// Typical source costs two to three bytes per occurrence.
+//
+// Positions are 0-based, with characters in UTF-16 code units as LSP uses.
+class IdentifierIndex {
+public:
+    struct Occurrence {
+        uint32_t line;
+        uint32_t character;
+    };
+
+    struct Location {
+        uint32_t file;     // see getFilePath
+        Occurrence position;
+    };
+
+    // One file's identifiers with their encoded postings, ready to be applied
+    // to any number of indexes without re-scanning the text
+    using FileTokens = std::vector<std::pair<std::string, std::string>>;
+
+    static FileTokens tokenize(const std::string& text);
+
+    // Replace one file's occurrences; empty tokens remove the file
+    void updateFile(const std::string& filePath, const FileTokens& tokens);
+    void clear();
+
+    // Every occurrence of the identifier, file by file, up to `limit`
+    std::vector<Location> find(const std::string& identifier, size_t limit,
+                               const CancellationToken* cancel = nullptr) const;
+
+    // Occurrences of the identifier on one line of one file
+    std::vector<Occurrence> findOnLine(const std::string& identifier, const std::string& filePath,
+                                       uint32_t line) const;
+
+    const std::string& getFilePath(uint32_t file) const { return m_filePaths[file]; }
+    size_t getFileCount() const { return m_filePaths.size(); }   // including removed files
+    size_t getIdentifierCount() const { return m_tokenIds.size(); }
+    size_t getPostingBytes() const { return m_postingBytes; }
+
+    // The identifier under (or just before) a UTF-16 character of one line;
+    // empty when the position is not on an identifier
+    static std::string identifierAt(const std::string& line, int character, int& startCharacter);
+
+private:
+    struct Postings {
+        uint32_t file;
+        uint32_t fileSlot;   // index of this list in m_fileTokens[file]
+        std::string bytes;
+    };
+
+    // Where a file's postings list sits, so removal never searches for it
+    struct FileToken {
+        uint32_t token;
+        uint32_t slot;       // index in m_postings[token]
+    };
+
+    std::unordered_map<std::string, uint32_t> m_tokenIds;
+    std::vector<std::string> m_tokens;                  // token id -> identifier
+    std::vector<std::vector<Postings>> m_postings;      // token id -> per-file postings
+    std::unordered_map<std::string, uint32_t> m_fileIds;
+    std::vector<std::string> m_filePaths;               // file id -> path
+    std::vector<std::vector<FileToken>> m_fileTokens;   // file id -> its postings lists
+    size_t m_postingBytes = 0;
+
+    void removeFile(uint32_t file);
+    uint32_t fileIdFor(const std::string& filePath);
+
+    static bool isIdentifierStart(char c);
+    static bool isIdentifierChar(char c);
+    static void appendVarint(std::string& out, uint32_t value);
+    static uint32_t readVarint(const std::string& bytes, size_t& pos);
+
+    template <typename Visitor>
+    static void decode(const std::string& bytes, Visitor visit);
+};
+
+#endif // IDENTIFIERINDEX_HPP
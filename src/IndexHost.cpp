@@ -0,0 +1,359 @@
+#include "IndexHost.hpp"
+#include "IndexSnapshot.hpp"
+#include "FileScanner.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+
+IndexHost::IndexHost(const std::string& rootPath)
+    : m_rootPath(rootPath)
+    , m_indexingStarted(false)
+    , m_front(std::make_shared<Buffer>())
+    , m_back(std::make_shared<Buffer>())
+    , m_leases(std::make_shared<Leases>())
+    , m_requestedGeneration(0)
+    , m_publisherStopping(false)
+    , m_publishedGeneration(0)
+    , m_indexed(false)
+{
+    m_publisher = std::thread([this]() { publisherLoop(); });
+}
+
+IndexHost::~IndexHost() {
+    stopIndexing();
+
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_publisherStopping = true;
+    }
+    m_pendingCondition.notify_all();
+    m_publisher.join();
+}
+
+bool IndexHost::setRoot(const std::string& rootPath) {
+    std::lock_guard<std::mutex> lock(m_rootMutex);
+    if (m_indexingStarted) {
+        return rootPath == m_rootPath;
+    }
+    m_rootPath = rootPath;
+    return true;
+}
+
+std::string IndexHost::getRoot() const {
+    std::lock_guard<std::mutex> lock(m_rootMutex);
+    return m_rootPath;
+}
+
+void IndexHost::startIndexing() {
+    stopIndexing();
+
+    std::string root;
+    {
+        std::lock_guard<std::mutex> lock(m_rootMutex);
+        if (m_rootPath.empty()) return;
+        m_indexingStarted = true;
+        root = m_rootPath;
+    }
+
+    m_indexingCancel = std::make_unique<CancellationToken>();
+    const CancellationToken* cancel = m_indexingCancel.get();
+    m_indexer = std::thread([this, root, cancel]() {
+        indexWorkspace(root, *cancel);
+    });
+}
+
+void IndexHost::ensureIndexed() {
+    {
+        std::lock_guard<std::mutex> lock(m_rootMutex);
+        if (m_indexingStarted) return;
+    }
+    startIndexing();
+}
+
+void IndexHost::stopIndexing() {
+    if (m_indexer.joinable()) {
+        m_indexingCancel->cancel();
+        m_indexer.join();
+    }
+}
+
+void IndexHost::rebuild() {
+    stopIndexing();
+
+    std::string root;
+    {
+        std::lock_guard<std::mutex> lock(m_rootMutex);
+        if (m_rootPath.empty()) return;
+        m_indexingStarted = true;
+        root = m_rootPath;
+    }
+
+    CancellationToken never;
+    indexWorkspace(root, never);
+}
+
+std::shared_ptr<const WorkspaceIndex> IndexHost::acquire() const {
+    std::lock_guard<std::mutex> lock(m_leases->mutex);
+    std::shared_ptr<Buffer> buffer = m_front;
+    buffer->readers++;
+
+    // The lease ends with the last copy of the returned pointer
+    std::shared_ptr<Leases> leases = m_leases;
+    return std::shared_ptr<const WorkspaceIndex>(&buffer->index, [buffer, leases](const WorkspaceIndex*) {
+        {
+            std::lock_guard<std::mutex> lock(leases->mutex);
+            buffer->readers--;
+        }
+        leases->released.notify_all();
+    });
+}
+
+void IndexHost::waitForIndex() const {
+    std::unique_lock<std::mutex> lock(m_indexedMutex);
+    m_indexedCondition.wait(lock, [this]() { return m_indexed; });
+}
+
+uint64_t IndexHost::publish(std::vector<WorkspaceIndex::FileUpdate> updates, bool skipOpenDocuments) {
+    return enqueue(PendingPublish{std::move(updates), {}, skipOpenDocuments});
+}
+
+uint64_t IndexHost::publishFromDisk(std::vector<std::string> changed, std::vector<std::string> removed) {
+    std::vector<WorkspaceIndex::FileUpdate> removals;
+    removals.reserve(removed.size());
+    for (const auto& path : removed) {
+        removals.push_back(WorkspaceIndex::FileUpdate::removal(path));
+    }
+    return enqueue(PendingPublish{std::move(removals), std::move(changed), true});
+}
+
+uint64_t IndexHost::enqueue(PendingPublish pending) {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        generation = ++m_requestedGeneration;
+        m_pending.push_back(std::move(pending));
+    }
+    m_pendingCondition.notify_one();
+    return generation;
+}
+
+bool IndexHost::waitForGeneration(uint64_t generation, const CancellationToken* cancel) const {
+    std::unique_lock<std::mutex> lock(m_generationMutex);
+    auto published = [this, generation]() { return m_publishedGeneration >= generation; };
+    if (!cancel) {
+        m_generationCondition.wait(lock, published);
+        return true;
+    }
+
+    // Tokens cannot wake us, so look at them between short waits
+    while (!m_generationCondition.wait_for(lock, CANCEL_POLL_INTERVAL, published)) {
+        if (cancel->isCancelled()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IndexHost::publisherLoop() {
+    std::deque<PendingPublish> batch;
+    while (true) {
+        uint64_t generation;
+        {
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
+            m_pendingCondition.wait(lock, [this]() { return m_publisherStopping || !m_pending.empty(); });
+            if (m_publisherStopping) {
+                return;
+            }
+            // Everything queued so far goes out in one swap
+            batch.swap(m_pending);
+            generation = m_requestedGeneration;
+        }
+
+        applyPending(batch);
+        batch.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(m_generationMutex);
+            m_publishedGeneration = generation;
+        }
+        m_generationCondition.notify_all();
+
+        // Catch the retired buffer up now rather than in front of the next
+        // publish, so a didChange after the initial scan applies only itself
+        catchUpBack();
+    }
+}
+
+void IndexHost::applyPending(std::deque<PendingPublish>& batch) {
+    // Parse every queued read in one go. A file's text is read now, so it can
+    // only be newer than the event that queued it and is safe to apply after
+    // the same publish's removals
+    for (auto& pending : batch) {
+        if (pending.reads.empty()) {
+            continue;
+        }
+        size_t first = pending.updates.size();
+        pending.updates.resize(first + pending.reads.size());
+        m_parsePool.parallelFor(pending.reads.size(), [&pending, first](size_t i) {
+            pending.updates[first + i] = WorkspaceIndex::FileUpdate::fromDisk(pending.reads[i]);
+        });
+    }
+
+    std::vector<WorkspaceIndex::FileUpdate> updates;
+    {
+        // Checked when the batch is applied, and publishes apply in order, so
+        // a markOpen either lands first and the disk version is dropped here,
+        // or the buffer it came with is applied after it
+        std::lock_guard<std::mutex> lock(m_openMutex);
+        for (auto& pending : batch) {
+            for (auto& update : pending.updates) {
+                if (!pending.skipOpenDocuments || !m_openDocuments.count(update.path)) {
+                    updates.push_back(std::move(update));
+                }
+            }
+        }
+    }
+
+    // The back buffer is caught up and free of readers; apply just these
+    for (const auto& update : updates) {
+        m_back->index.updateFile(update);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_leases->mutex);
+        std::swap(m_front, m_back);
+    }
+    m_backlog = std::move(updates);
+}
+
+void IndexHost::catchUpBack() {
+    waitForReaders(*m_back);
+    for (const auto& update : m_backlog) {
+        m_back->index.updateFile(update);
+    }
+    m_backlog.clear();
+}
+
+void IndexHost::markOpen(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(m_openMutex);
+    m_openDocuments[filePath]++;
+}
+
+void IndexHost::markClosed(const std::string& filePath) {
+    std::lock_guard<std::mutex> lock(m_openMutex);
+    auto it = m_openDocuments.find(filePath);
+    if (it != m_openDocuments.end() && --it->second == 0) {
+        m_openDocuments.erase(it);
+    }
+}
+
+void IndexHost::setProgressCallback(ProgressCallback callback) {
+    m_progressCallback = std::move(callback);
+}
+
+void IndexHost::setLogCallback(LogCallback callback) {
+    m_logCallback = std::move(callback);
+}
+
+void IndexHost::indexWorkspace(const std::string& root, const CancellationToken& cancel) {
+    auto started = std::chrono::steady_clock::now();
+    progress("begin", "Indexing", 0);
+    log("Indexing workspace: " + root);
+
+    auto files = FileScanner::scanForAllSupportedFiles(root);
+    WatchJournal::FileTable states = WatchJournal::statFiles(files, m_parsePool);
+
+    // Files whose (mtime, size) still match the snapshot are served from it
+    // straight away; only the rest are parsed
+    IndexSnapshot snapshot(WatchJournal::defaultDirectory(root), root);
+    IndexSnapshot::Entries entries;
+    snapshot.load(entries);
+
+    std::vector<std::string> stale;
+    bool changed = IndexSnapshot::reconcile(entries, files, states, stale);
+
+    std::vector<WorkspaceIndex::FileUpdate> initial;
+    initial.reserve(entries.size());
+    for (const auto& entry : entries) {
+        initial.push_back(entry.second.update);
+    }
+    size_t reused = initial.size();
+
+    // Files the index knows about that are gone now
+    {
+        auto index = acquire();
+        const IdentifierIndex& identifiers = index->getIdentifiers();
+        for (uint32_t file = 0; file < identifiers.getFileCount(); file++) {
+            if (!states.count(identifiers.getFilePath(file))) {
+                initial.push_back(WorkspaceIndex::FileUpdate::removal(identifiers.getFilePath(file)));
+            }
+        }
+    }
+
+    uint64_t generation = 0;
+    if (!initial.empty()) {
+        generation = publish(std::move(initial), true);
+    }
+    if (reused > 0) {
+        progress("report", std::to_string(reused) + " files from snapshot", 0);
+    }
+
+    // Parse the rest in parallel, publishing each chunk as soon as it is done
+    for (size_t begin = 0; begin < stale.size() && !cancel.isCancelled(); begin += INDEX_CHUNK_SIZE) {
+        size_t end = std::min(stale.size(), begin + INDEX_CHUNK_SIZE);
+        std::vector<WorkspaceIndex::FileUpdate> parsed(end - begin);
+        m_parsePool.parallelFor(parsed.size(), [&](size_t i) {
+            parsed[i] = WorkspaceIndex::FileUpdate::fromDisk(stale[begin + i]);
+        });
+
+        for (size_t i = 0; i < parsed.size(); i++) {
+            entries[stale[begin + i]] = IndexSnapshot::Entry{states[stale[begin + i]], parsed[i]};
+        }
+        generation = publish(std::move(parsed), true);
+
+        progress("report", std::to_string(end) + "/" + std::to_string(stale.size()) + " files",
+                 static_cast<int>(end * 100 / stale.size()));
+    }
+
+    // Waiters are released either way, once what was parsed is visible;
+    // a cancelled scan is as far as it gets
+    waitForGeneration(generation);
+    {
+        std::lock_guard<std::mutex> lock(m_indexedMutex);
+        m_indexed = true;
+    }
+    m_indexedCondition.notify_all();
+
+    if (cancel.isCancelled()) {
+        progress("end", "Cancelled");
+        return;
+    }
+
+    if (changed && !snapshot.save(entries)) {
+        log("Could not write the index snapshot for " + root);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    progress("end", "");
+    log("Index ready with " + std::to_string(acquire()->size()) + " symbols (" +
+        std::to_string(reused) + " files from snapshot, " + std::to_string(stale.size()) +
+        " parsed) in " + std::to_string(elapsed.count()) + "ms");
+}
+
+void IndexHost::waitForReaders(const Buffer& buffer) {
+    // Only the front buffer gains leases, so once the back one drains it stays ours
+    std::unique_lock<std::mutex> lock(m_leases->mutex);
+    m_leases->released.wait(lock, [&buffer]() { return buffer.readers == 0; });
+}
+
+void IndexHost::progress(const std::string& kind, const std::string& message, int percentage) const {
+    if (m_progressCallback) {
+        m_progressCallback(kind, message, percentage);
+    }
+}
+
+void IndexHost::log(const std::string& message) const {
+    if (m_logCallback) {
+        m_logCallback(message);
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef INDEXHOST_HPP
+#define INDEXHOST_HPP
+
+#include "WorkspaceIndex.hpp"
+#include "CancellationToken.hpp"
+#include "ThreadPool.hpp"
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <deque>
+#include <cstdint>
+
+// The published index for one workspace root and the thread that fills it.
+// An LSP server over stdio owns one; a daemon shares one between all of its
+// clients, so memory scales with roots rather than with editor windows.
+//
+// Readers lease a snapshot with acquire(). Updates are queued to a publisher
+// thread that applies them to the back buffer and swaps it in, then waits for
+// the retired buffer's leases to drain and catches it up, so callers of
+// publish() never block on readers.
+class IndexHost {
+public:
+    // kind is "begin", "report" or "end"; percentage is -1 when unknown
+    using ProgressCallback = std::function<void(const std::string& kind, const std::string& message, int percentage)>;
+    using LogCallback = std::function<void(const std::string& message)>;
+
+    explicit IndexHost(const std::string& rootPath = "");
+    ~IndexHost();
+
+    IndexHost(const IndexHost&) = delete;
+    IndexHost& operator=(const IndexHost&) = delete;
+
+    // The root can change until indexing first starts; false afterwards
+    bool setRoot(const std::string& rootPath);
+    std::string getRoot() const;
+
+    // Scan in the background: the persisted snapshot is served first, then
+    // parsed files are published as they complete. ensureIndexed starts
+    // the scan only if none has run yet; rebuild runs one on the calling thread.
+    void startIndexing();
+    void ensureIndexed();
+    void stopIndexing();
+    void rebuild();
+
+    // Current index snapshot; stays valid, and its buffer untouched, for as
+    // long as the caller holds it
+    std::shared_ptr<const WorkspaceIndex> acquire() const;
+
+    // Block until the first scan has finished (or been stopped), for callers
+    // that want complete answers rather than partial ones
+    void waitForIndex() const;
+
+    // Queue file updates for publishing and return at once. Updates read from
+    // disk pass skipOpenDocuments so they never replace a client's unsaved
+    // buffer. The returned generation is in acquire() once it is published
+    uint64_t publish(std::vector<WorkspaceIndex::FileUpdate> updates, bool skipOpenDocuments = false);
+
+    // Queue files to re-read from disk, for file watchers: they are parsed on
+    // the publisher's pool, so the caller never waits on a parse. Removals go
+    // first; open documents are skipped as with skipOpenDocuments
+    uint64_t publishFromDisk(std::vector<std::string> changed, std::vector<std::string> removed = {});
+
+    // Block until the given generation is published; false if cancelled first
+    bool waitForGeneration(uint64_t generation, const CancellationToken* cancel = nullptr) const;
+
+    // Documents open in any client, counted, since several may share a file
+    void markOpen(const std::string& filePath);
+    void markClosed(const std::string& filePath);
+
+    void setProgressCallback(ProgressCallback callback);
+    void setLogCallback(LogCallback callback);
+
+private:
+    // Files parsed between publishes (and progress reports) while indexing
+    static constexpr size_t INDEX_CHUNK_SIZE = 256;
+
+    std::string m_rootPath;
+    bool m_indexingStarted;
+    mutable std::mutex m_rootMutex;
+
+    // How often a cancellable wait for a generation checks its token
+    static constexpr std::chrono::milliseconds CANCEL_POLL_INTERVAL{5};
+
+    // One index copy and the number of readers leasing it
+    struct Buffer {
+        WorkspaceIndex index;
+        size_t readers = 0;
+    };
+
+    // Outlives the host while any lease is still held
+    struct Leases {
+        std::mutex mutex;
+        std::condition_variable released;
+    };
+
+    struct PendingPublish {
+        std::vector<WorkspaceIndex::FileUpdate> updates;
+        std::vector<std::string> reads;  // parsed from disk after updates
+        bool skipOpenDocuments;
+    };
+
+    std::shared_ptr<Buffer> m_front;              // guarded by m_leases->mutex
+    std::shared_ptr<Buffer> m_back;               // publisher thread only
+    std::shared_ptr<Leases> m_leases;
+    std::vector<WorkspaceIndex::FileUpdate> m_backlog;  // applied to m_front, not yet to m_back
+
+    std::unordered_map<std::string, int> m_openDocuments;
+    std::mutex m_openMutex;
+
+    std::thread m_publisher;
+    ThreadPool m_parsePool;  // scans and publishFromDisk reads
+    std::deque<PendingPublish> m_pending;
+    uint64_t m_requestedGeneration;
+    bool m_publisherStopping;
+    std::mutex m_pendingMutex;
+    std::condition_variable m_pendingCondition;
+
+    uint64_t m_publishedGeneration;
+    mutable std::mutex m_generationMutex;
+    mutable std::condition_variable m_generationCondition;
+
+    std::thread m_indexer;
+    std::unique_ptr<CancellationToken> m_indexingCancel;
+    bool m_indexed;
+    mutable std::mutex m_indexedMutex;
+    mutable std::condition_variable m_indexedCondition;
+
+    ProgressCallback m_progressCallback;
+    LogCallback m_logCallback;
+
+    void indexWorkspace(const std::string& root, const CancellationToken& cancel);
+    uint64_t enqueue(PendingPublish pending);
+    void publisherLoop();
+    void applyPending(std::deque<PendingPublish>& batch);
+    void catchUpBack();
+    void waitForReaders(const Buffer& buffer);
+    void progress(const std::string& kind, const std::string& message, int percentage = -1) const;
+    void log(const std::string& message) const;
+};
+
+#endif // INDEXHOST_HPP
@@ -0,0 +1,162 @@
+#include "IndexSnapshot.hpp"
+#include "BinaryFormat.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// Bump the version whenever the parsers or the postings encoding change
+const char INDEX_MAGIC[8] = {'N', 'A', 'V', 'I', 'X', 'I', '0', '1'};
+
+} // namespace
+
+IndexSnapshot::IndexSnapshot(const std::string& directory, const std::string& rootPath)
+    : m_directory(directory)
+    , m_rootPath(rootPath)
+{
+}
+
+bool IndexSnapshot::load(Entries& entries) const {
+    entries.clear();
+
+    std::ifstream in(indexPath(), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (buffer.size() < sizeof(INDEX_MAGIC) + sizeof(uint64_t) + sizeof(uint32_t) ||
+        std::memcmp(buffer.data(), INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) {
+        return false;
+    }
+
+    size_t bodySize = buffer.size() - sizeof(uint32_t);
+    uint32_t stored;
+    std::memcpy(&stored, buffer.data() + bodySize, sizeof(stored));
+    if (stored != WatchJournal::checksum(buffer.substr(0, bodySize))) {
+        std::cerr << "⚠️  Index snapshot is corrupt, reindexing from scratch\n";
+        return false;
+    }
+
+    BinaryReader reader(buffer.data() + sizeof(INDEX_MAGIC), bodySize - sizeof(INDEX_MAGIC));
+    uint64_t count = reader.value<uint64_t>();
+    entries.reserve(count);
+    for (uint64_t i = 0; i < count && reader.ok(); i++) {
+        Entry entry;
+        entry.update.path = absolutePath(reader.string());
+        entry.state.mtime = reader.value<int64_t>();
+        entry.state.size = reader.value<uint64_t>();
+
+        uint32_t symbolCount = reader.value<uint32_t>();
+        for (uint32_t s = 0; s < symbolCount && reader.ok(); s++) {
+            std::string name = reader.string();
+            auto type = static_cast<SymbolType>(reader.value<uint16_t>());
+            int32_t line = reader.value<int32_t>();
+            std::string context = reader.string();
+            if (type > SymbolType::UNKNOWN) {
+                type = SymbolType::UNKNOWN;
+            }
+            entry.update.symbols.emplace_back(name, type, entry.update.path, line, context);
+        }
+
+        uint32_t tokenCount = reader.value<uint32_t>();
+        entry.update.tokens.reserve(tokenCount);
+        for (uint32_t t = 0; t < tokenCount && reader.ok(); t++) {
+            std::string identifier = reader.string();
+            entry.update.tokens.emplace_back(std::move(identifier), reader.string());
+        }
+
+        if (reader.ok()) {
+            std::string path = entry.update.path;
+            entries.emplace(std::move(path), std::move(entry));
+        }
+    }
+
+    if (!reader.ok()) {
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool IndexSnapshot::save(const Entries& entries) const {
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        return false;
+    }
+
+    std::string buffer(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    putValue<uint64_t>(buffer, entries.size());
+    for (const auto& item : entries) {
+        const Entry& entry = item.second;
+        putString(buffer, relativePath(item.first));
+        putValue<int64_t>(buffer, entry.state.mtime);
+        putValue<uint64_t>(buffer, entry.state.size);
+
+        // Symbol.file is the entry's own path and is not repeated
+        putValue<uint32_t>(buffer, static_cast<uint32_t>(entry.update.symbols.size()));
+        for (const Symbol& symbol : entry.update.symbols) {
+            putString(buffer, symbol.name);
+            putValue<uint16_t>(buffer, static_cast<uint16_t>(symbol.type));
+            putValue<int32_t>(buffer, symbol.line);
+            putString(buffer, symbol.context);
+        }
+
+        putValue<uint32_t>(buffer, static_cast<uint32_t>(entry.update.tokens.size()));
+        for (const auto& token : entry.update.tokens) {
+            putString(buffer, token.first);
+            putString(buffer, token.second);
+        }
+    }
+    putValue<uint32_t>(buffer, WatchJournal::checksum(buffer));
+
+    return WatchJournal::replaceFile(indexPath(), buffer);
+}
+
+bool IndexSnapshot::reconcile(Entries& entries, const std::vector<std::string>& files,
+                              const WatchJournal::FileTable& states, std::vector<std::string>& stale) {
+    stale.clear();
+    for (const auto& file : files) {
+        auto state = states.find(file);
+        if (state == states.end()) {
+            continue;
+        }
+        auto entry = entries.find(file);
+        if (entry == entries.end() || entry->second.state != state->second) {
+            stale.push_back(file);
+        }
+    }
+
+    bool changed = !stale.empty();
+    for (auto it = entries.begin(); it != entries.end();) {
+        auto state = states.find(it->first);
+        if (state != states.end() && state->second == it->second.state) {
+            ++it;
+        } else {
+            it = entries.erase(it);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+std::string IndexSnapshot::indexPath() const {
+    return m_directory + "/index";
+}
+
+std::string IndexSnapshot::relativePath(const std::string& path) const {
+    if (path.size() > m_rootPath.size() && path.compare(0, m_rootPath.size(), m_rootPath) == 0 &&
+        path[m_rootPath.size()] == '/') {
+        return path.substr(m_rootPath.size() + 1);
+    }
+    return path;
+}
+
+std::string IndexSnapshot::absolutePath(const std::string& relative) const {
+    if (!relative.empty() && relative[0] == '/') {
+        return relative;
+    }
+    return m_rootPath + "/" + relative;
+}
@@ -0,0 +1,46 @@
+#ifndef INDEXSNAPSHOT_HPP
+#define INDEXSNAPSHOT_HPP
+
+#include "WorkspaceIndex.hpp"
+#include "WatchJournal.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Parsed contents of every workspace file as of the last full scan, kept in
+// the watch journal directory so a restarted server can answer from it before
+// parsing anything. Each entry records the (mtime, size) it was parsed at; a
+// file whose state still matches is reused as is.
+//
+// One file, written aside and renamed over the old copy, with a trailing
+// checksum. Paths are stored relative to the root.
+class IndexSnapshot {
+public:
+    struct Entry {
+        WatchJournal::FileState state;
+        WorkspaceIndex::FileUpdate update;
+    };
+    using Entries = std::unordered_map<std::string, Entry>;
+
+    IndexSnapshot(const std::string& directory, const std::string& rootPath);
+
+    // False when there is no usable snapshot; entries are then left empty
+    bool load(Entries& entries) const;
+    bool save(const Entries& entries) const;
+
+    // Keep only the entries whose file still has the (mtime, size) in states,
+    // and list the scanned files that have to be parsed again. True when
+    // anything was dropped or is stale, i.e. the snapshot needs saving.
+    static bool reconcile(Entries& entries, const std::vector<std::string>& files,
+                          const WatchJournal::FileTable& states, std::vector<std::string>& stale);
+
+private:
+    std::string m_directory;
+    std::string m_rootPath;
+
+    std::string indexPath() const;
+    std::string relativePath(const std::string& path) const;
+    std::string absolutePath(const std::string& relative) const;
+};
+
+#endif // INDEXSNAPSHOT_HPP
@@ -0,0 +1,209 @@
+#include "IndexWorker.hpp"
+#include "PerformanceLogger.hpp"
+#include <iostream>
+#include <unordered_map>
+
+IndexWorker::IndexWorker(size_t threadCount)
+    : m_generation(0)
+    , m_parsePool(threadCount)
+    , m_stopping(false)
+    , m_logger(nullptr)
+{
+}
+
+IndexWorker::~IndexWorker() {
+    stop();
+}
+
+void IndexWorker::start(const std::vector<Symbol>& initialSymbols) {
+    if (m_thread.joinable()) {
+        return;
+    }
+
+    auto front = std::make_shared<AutocompleteEngine>();
+    front->buildIndex(initialSymbols);
+    m_back = std::make_shared<AutocompleteEngine>();
+    m_back->buildIndex(initialSymbols);
+    std::atomic_store(&m_front, front);
+
+    m_stopping = false;
+    m_thread = std::thread([this]() { workerLoop(); });
+}
+
+void IndexWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_stopping = true;
+    }
+    m_queueCondition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void IndexWorker::submit(const std::vector<FileChange>& batch) {
+    if (batch.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queue.push_back(batch);
+    }
+    m_queueCondition.notify_one();
+}
+
+std::shared_ptr<const AutocompleteEngine> IndexWorker::acquire() const {
+    return std::atomic_load(&m_front);
+}
+
+uint64_t IndexWorker::getGeneration() const {
+    return m_generation;
+}
+
+size_t IndexWorker::getPendingBatchCount() const {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_queue.size();
+}
+
+void IndexWorker::setPerformanceLogger(PerformanceLogger* logger) {
+    m_logger = logger;
+}
+
+ThreadPool& IndexWorker::getParsePool() {
+    return m_parsePool;
+}
+
+void IndexWorker::setPublishCallback(PublishCallback callback) {
+    m_publishCallback = callback;
+}
+
+void IndexWorker::workerLoop() {
+    while (true) {
+        std::vector<FileChange> changes;
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueCondition.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+
+            if (m_stopping) {
+                return;
+            }
+
+            // Everything queued while the last batch was indexing goes in one generation
+            while (!m_queue.empty()) {
+                auto& batch = m_queue.front();
+                changes.insert(changes.end(), batch.begin(), batch.end());
+                m_queue.pop_front();
+            }
+        }
+
+        auto parseStart = std::chrono::steady_clock::now();
+        ParsedBatch batch = parseBatch(changes);
+        auto parseTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - parseStart);
+
+        // Bring the back buffer up to date with the previous generation first
+        waitForReaders();
+        applyBatch(*m_back, m_backlog);
+        applyBatch(*m_back, batch);
+
+        std::shared_ptr<AutocompleteEngine> published = m_back;
+        m_back = std::atomic_exchange(&m_front, published);
+        uint64_t generation = ++m_generation;
+
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now() - batch.firstEvent);
+        size_t fileCount = batch.files.size();
+        m_backlog = std::move(batch);
+
+        if (m_logger) {
+            m_logger->logReindex(fileCount, parseTime, latency);
+        }
+        if (m_publishCallback) {
+            m_publishCallback(generation, fileCount, latency);
+        }
+    }
+}
+
+IndexWorker::ParsedBatch IndexWorker::parseBatch(const std::vector<FileChange>& changes) {
+    ParsedBatch batch;
+    batch.firstEvent = std::chrono::system_clock::now();
+
+    // Later events for a path supersede earlier ones
+    std::unordered_map<std::string, size_t> slots;
+    for (const auto& change : changes) {
+        batch.firstEvent = std::min(batch.firstEvent, change.timestamp);
+
+        auto inserted = slots.emplace(change.path, batch.files.size());
+        if (inserted.second) {
+            batch.files.push_back({change.path, false, false, "", {}});
+        }
+        
+        ParsedFile& file = batch.files[inserted.first->second];
+        file.deleted = change.event == FileEvent::DELETED;
+        
+        if (change.event != FileEvent::MOVED) {
+            file.reparse = !file.deleted;
+            continue;
+        }
+        
+        // A rename relocates the existing symbols; only content changes need a parse
+        file.renamedFrom = change.oldPath;
+        file.reparse = false;
+        
+        // The old path may already have pending work in this batch. Its slot is
+        // applied first and would act on a file that no longer exists, so its
+        // state follows the file to the new path and the old path is dropped
+        auto previous = slots.find(change.oldPath);
+        if (previous != slots.end() && previous->second != inserted.first->second) {
+            ParsedFile& from = batch.files[previous->second];
+            if (!from.renamedFrom.empty() && !from.reparse && !from.deleted) {
+                // Chained rename: relocate straight from the original path
+                file.renamedFrom = from.renamedFrom;
+                from.renamedFrom.clear();
+            } else {
+                // Changed before it moved: the engine's copy is stale, parse the new path
+                file.renamedFrom.clear();
+                file.reparse = true;
+            }
+            from.deleted = true;
+            from.reparse = false;
+        }
+    }
+
+    m_parsePool.parallelFor(batch.files.size(), [&batch](size_t i) {
+        ParsedFile& file = batch.files[i];
+        if (!file.reparse) {
+            return;
+        }
+
+        SymbolIndex index;
+        index.indexFile(file.path);
+        file.symbols = index.getSymbols();
+    });
+
+    return batch;
+}
+
+void IndexWorker::applyBatch(AutocompleteEngine& engine, const ParsedBatch& batch) {
+    for (const auto& file : batch.files) {
+        if (!file.renamedFrom.empty()) {
+            engine.renameFile(file.renamedFrom, file.path);
+        }
+        
+        if (file.deleted) {
+            engine.removeFile(file.path);
+        } else if (file.reparse) {
+            engine.updateFile(file.path, file.symbols);
+        }
+    }
+}
+
+void IndexWorker::waitForReaders() {
+    // Readers that acquired the old front before the last swap still hold it;
+    // the buffer is ours again once only m_back references it
+    while (m_back.use_count() > 1) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef INDEXWORKER_HPP
+#define INDEXWORKER_HPP
+
+#include "AutocompleteEngine.hpp"
+#include "FileWatcher.hpp"
+#include "ThreadPool.hpp"
+#include <memory>
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+class PerformanceLogger;
+
+// Applies debounced file change batches to the completion index off the
+// watcher thread. Two engines are double-buffered: the worker updates the
+// back engine, publishes it with an atomic pointer swap, and catches the
+// old front up on the next batch once readers have let go of it.
+class IndexWorker {
+public:
+    using PublishCallback = std::function<void(uint64_t generation, size_t fileCount,
+                                               std::chrono::microseconds latency)>;
+
+    // threadCount == 0 uses std::thread::hardware_concurrency() for parsing
+    explicit IndexWorker(size_t threadCount = 0);
+    ~IndexWorker();
+
+    IndexWorker(const IndexWorker&) = delete;
+    IndexWorker& operator=(const IndexWorker&) = delete;
+
+    // Build both buffers from the initial scan and start the worker thread
+    void start(const std::vector<Symbol>& initialSymbols);
+    void stop();
+
+    // Queue a batch for re-indexing; never blocks on parsing
+    void submit(const std::vector<FileChange>& batch);
+
+    // Current published index. Readers keep the snapshot alive while they use it
+    std::shared_ptr<const AutocompleteEngine> acquire() const;
+    uint64_t getGeneration() const;
+    size_t getPendingBatchCount() const;
+
+    void setPerformanceLogger(PerformanceLogger* logger);
+    void setPublishCallback(PublishCallback callback);
+
+    // The parse pool, for startup work that should not spin up threads of its own
+    ThreadPool& getParsePool();
+
+private:
+    struct ParsedFile {
+        std::string path;
+        bool deleted;
+        bool reparse;
+        std::string renamedFrom;  // symbols are relocated from here before any reparse
+        std::vector<Symbol> symbols;
+    };
+
+    struct ParsedBatch {
+        std::vector<ParsedFile> files;
+        std::chrono::system_clock::time_point firstEvent;
+    };
+
+    std::shared_ptr<AutocompleteEngine> m_front;  // accessed with std::atomic_load/store
+    std::shared_ptr<AutocompleteEngine> m_back;
+    ParsedBatch m_backlog;                        // last batch not yet applied to m_back
+    std::atomic<uint64_t> m_generation;
+
+    std::thread m_thread;
+    ThreadPool m_parsePool;
+    std::deque<std::vector<FileChange>> m_queue;
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    bool m_stopping;
+
+    PerformanceLogger* m_logger;
+    PublishCallback m_publishCallback;
+
+    void workerLoop();
+    ParsedBatch parseBatch(const std::vector<FileChange>& changes);
+    void applyBatch(AutocompleteEngine& engine, const ParsedBatch& batch);
+    void waitForReaders();
+};
+
+#endif // INDEXWORKER_HPP
@@ -80,35 +80,31 @@ std::string JsonExporter::exportForLSP(const SymbolIndex& index, const std::stri
     return json.str();
 }
 
-std::string JsonExporter::exportDocumentSymbols(const SymbolIndex& index, const std::string& filePath) const {
-    std::ostringstream json;
+std::string JsonExporter::exportDocumentSymbols(const SymbolIndex& index, const std::string& filePath,
+                                                const CancellationToken* cancel) const {
+    // The file's symbols are one contiguous slice of the index
+    SymbolSlice fileSymbols = index.getFileSymbols(filePath);
     
-    json << "[\n";
-    
-    const auto& symbols = index.getSymbols();
-    std::vector<Symbol> fileSymbols;
-    
-    // Filter symbols for the specific file
-    for (const auto& symbol : symbols) {
-        if (symbol.file == filePath) {
-            fileSymbols.push_back(symbol);
-        }
-    }
+    std::string json;
+    json.reserve(64 + fileSymbols.size() * 256);
     
+    json += '[';
     for (size_t i = 0; i < fileSymbols.size(); ++i) {
-        json << symbolToLSP(fileSymbols[i]);
-        if (i < fileSymbols.size() - 1) {
-            json << ",";
+        if ((i & CANCEL_CHECK_MASK) == 0 && CancellationToken::isCancelled(cancel)) {
+            return "[]";
         }
-        json << "\n";
+        if (i > 0) {
+            json += ',';
+        }
+        appendSymbolLSP(json, fileSymbols[i]);
     }
+    json += ']';
     
-    json << "]\n";
-    
-    return json.str();
+    return json;
 }
 
-std::string JsonExporter::exportWorkspaceSymbols(const SymbolIndex& index, const std::string& query) const {
+std::string JsonExporter::exportWorkspaceSymbols(const SymbolIndex& index, const std::string& query,
+                                                 const CancellationToken* cancel) const {
     std::ostringstream json;
     
     json << "[\n";
@@ -120,14 +116,20 @@ std::string JsonExporter::exportWorkspaceSymbols(const SymbolIndex& index, const
     if (query.empty()) {
         filteredSymbols = symbols;
     } else {
-        for (const auto& symbol : symbols) {
-            if (symbol.name.find(query) != std::string::npos) {
-                filteredSymbols.push_back(symbol);
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            if ((i & CANCEL_CHECK_MASK) == 0 && CancellationToken::isCancelled(cancel)) {
+                return "[]";
+            }
+            if (symbols[i].name.find(query) != std::string::npos) {
+                filteredSymbols.push_back(symbols[i]);
             }
         }
     }
     
     for (size_t i = 0; i < filteredSymbols.size(); ++i) {
+        if ((i & CANCEL_CHECK_MASK) == 0 && CancellationToken::isCancelled(cancel)) {
+            return "[]";
+        }
         json << "    {\n";
         json << "      \"name\": \"" << escapeJson(filteredSymbols[i].name) << "\",\n";
         json << "      \"kind\": " << symbolTypeToLSPKind(filteredSymbols[i].type) << ",\n";
@@ -297,6 +299,63 @@ std::string JsonExporter::exportByLanguage(const SymbolIndex& index) const {
     return json.str();
 }
 
+std::string JsonExporter::exportSymbolInformation(const std::vector<AutocompleteResult>& results) const {
+    std::string json;
+    json.reserve(64 + results.size() * 192);
+    
+    json += '[';
+    for (size_t i = 0; i < results.size(); ++i) {
+        const AutocompleteResult& result = results[i];
+        std::string line = std::to_string(result.line - 1);
+        
+        if (i > 0) {
+            json += ',';
+        }
+        json += "{\"name\":\"";
+        appendEscaped(json, result.suggestion);
+        json += "\",\"kind\":";
+        json += std::to_string(symbolTypeToLSPKind(result.type));
+        json += ",\"location\":{\"uri\":\"file://";
+        appendEscaped(json, result.file);
+        json += "\",\"range\":{\"start\":{\"line\":";
+        json += line;
+        json += ",\"character\":0},\"end\":{\"line\":";
+        json += line;
+        json += ",\"character\":";
+        json += std::to_string(result.suggestion.length());
+        json += "}}},\"containerName\":\"";
+        appendEscaped(json, result.file);
+        json += "\"}";
+    }
+    json += ']';
+    
+    return json;
+}
+
+void JsonExporter::appendEscaped(std::string& out, const std::string& str) {
+    static const char hex[] = "0123456789abcdef";
+    for (char c : str) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c >= 0 && c < 32) {
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0xF];
+                    out += hex[c & 0xF];
+                } else {
+                    out += c;
+                }
+                break;
+        }
+    }
+}
+
 std::string JsonExporter::escapeJson(const std::string& str) const {
     std::ostringstream escaped;
     for (char c : str) {
@@ -336,6 +395,26 @@ std::string JsonExporter::symbolToJson(const Symbol& symbol, int indent) const {
     return json.str();
 }
 
+void JsonExporter::appendSymbolLSP(std::string& out, const Symbol& symbol) const {
+    std::string line = std::to_string(symbol.line - 1);
+    
+    out += "{\"name\":\"";
+    appendEscaped(out, symbol.name);
+    out += "\",\"kind\":";
+    out += std::to_string(symbolTypeToLSPKind(symbol.type));
+    out += ",\"location\":{\"uri\":\"file://";
+    appendEscaped(out, symbol.file);
+    out += "\",\"range\":{\"start\":{\"line\":";
+    out += line;
+    out += ",\"character\":0},\"end\":{\"line\":";
+    out += line;
+    out += ",\"character\":";
+    out += std::to_string(symbol.name.length());
+    out += "}}},\"detail\":\"";
+    appendEscaped(out, symbol.context);
+    out += "\"}";
+}
+
 std::string JsonExporter::symbolToLSP(const Symbol& symbol) const {
     std::ostringstream json;
     
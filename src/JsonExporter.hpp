@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Symbol.hpp"
+#include "CancellationToken.hpp"
+#include "AutocompleteEngine.hpp"
 #include <string>
 #include <vector>
 #include <fstream>
@@ -19,19 +21,35 @@ public:
     
     // LSP-compatible exports
     std::string exportForLSP(const SymbolIndex& index, const std::string& uri = "") const;
-    std::string exportDocumentSymbols(const SymbolIndex& index, const std::string& filePath) const;
-    std::string exportWorkspaceSymbols(const SymbolIndex& index, const std::string& query = "") const;
+    // Compact JSON appended into one buffer; a cancelled export stops
+    // scanning and returns an empty array
+    std::string exportDocumentSymbols(const SymbolIndex& index, const std::string& filePath,
+                                      const CancellationToken* cancel = nullptr) const;
+    std::string exportWorkspaceSymbols(const SymbolIndex& index, const std::string& query = "",
+                                       const CancellationToken* cancel = nullptr) const;
+    
+    // Compact SymbolInformation[] for already ranked and capped results,
+    // appended straight into one buffer
+    std::string exportSymbolInformation(const std::vector<AutocompleteResult>& results) const;
     
     // Specialized formats
     std::string exportCompact(const SymbolIndex& index) const;
     std::string exportWithStats(const SymbolIndex& index, const std::string& projectPath) const;
     std::string exportByLanguage(const SymbolIndex& index) const;
+    
+    // Appends str as the body of a JSON string; control characters without a
+    // short escape become \u00XX
+    static void appendEscaped(std::string& out, const std::string& str);
 
 private:
+    // Cancellation is polled once per this many symbols
+    static const size_t CANCEL_CHECK_MASK = 4095;
+    
     // JSON formatting helpers
     std::string escapeJson(const std::string& str) const;
     std::string symbolToJson(const Symbol& symbol, int indent = 0) const;
     std::string symbolToLSP(const Symbol& symbol) const;
+    void appendSymbolLSP(std::string& out, const Symbol& symbol) const;   // compact form of symbolToLSP
     
     // LSP helpers
     int symbolTypeToLSPKind(SymbolType type) const;
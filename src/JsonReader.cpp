@@ -0,0 +1,388 @@
+#include "JsonReader.hpp"
+#include <charconv>
+#include <cstring>
+
+bool JsonDocument::parse(std::string text) {
+    m_text = std::move(text);
+    m_nodes.clear();
+    m_error.clear();
+    m_pos = 0;
+
+    // Most LSP messages are a few dozen values; didChange bodies are mostly one long string
+    m_nodes.reserve(64);
+
+    if (!parseValue(0)) {
+        m_nodes.clear();
+        return false;
+    }
+
+    skipWhitespace();
+    if (m_pos != m_text.size()) {
+        m_nodes.clear();
+        return fail("trailing characters after JSON value");
+    }
+    return true;
+}
+
+JsonView JsonDocument::root() const {
+    return m_nodes.empty() ? JsonView() : JsonView(this, 0);
+}
+
+bool JsonDocument::parseValue(int depth) {
+    if (depth > MAX_DEPTH) {
+        return fail("nesting too deep");
+    }
+
+    skipWhitespace();
+    if (m_pos >= m_text.size()) {
+        return fail("unexpected end of input");
+    }
+
+    char c = m_text[m_pos];
+    if (c == '{' || c == '[') {
+        bool isObject = c == '{';
+        char close = isObject ? '}' : ']';
+        uint32_t index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back({isObject ? Type::OBJECT : Type::ARRAY, false, static_cast<uint32_t>(m_pos), 0, 0, 0});
+        m_pos++;
+
+        uint32_t count = 0;
+        skipWhitespace();
+        if (m_pos < m_text.size() && m_text[m_pos] == close) {
+            m_pos++;
+        } else {
+            while (true) {
+                if (isObject) {
+                    skipWhitespace();
+                    if (m_pos >= m_text.size() || m_text[m_pos] != '"') {
+                        return fail("expected object key");
+                    }
+                    Node key{Type::STRING, false, 0, 0, 0, 0};
+                    if (!parseString(key)) {
+                        return false;
+                    }
+                    key.next = static_cast<uint32_t>(m_nodes.size() + 1);
+                    m_nodes.push_back(key);
+
+                    skipWhitespace();
+                    if (m_pos >= m_text.size() || m_text[m_pos] != ':') {
+                        return fail("expected ':' after object key");
+                    }
+                    m_pos++;
+                }
+
+                if (!parseValue(depth + 1)) {
+                    return false;
+                }
+                count++;
+
+                skipWhitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == ',') {
+                    m_pos++;
+                    continue;
+                }
+                if (m_pos < m_text.size() && m_text[m_pos] == close) {
+                    m_pos++;
+                    break;
+                }
+                return fail(isObject ? "expected ',' or '}'" : "expected ',' or ']'");
+            }
+        }
+
+        Node& node = m_nodes[index];
+        node.count = count;
+        node.length = static_cast<uint32_t>(m_pos - node.start);
+        node.next = static_cast<uint32_t>(m_nodes.size());
+        return true;
+    }
+
+    Node node{Type::NUL, false, static_cast<uint32_t>(m_pos), 0, 0, 0};
+    bool ok;
+    switch (c) {
+        case '"':
+            ok = parseString(node);
+            break;
+        case 't':
+            return parseLiteral("true", Type::BOOLEAN);
+        case 'f':
+            return parseLiteral("false", Type::BOOLEAN);
+        case 'n':
+            return parseLiteral("null", Type::NUL);
+        default:
+            ok = parseNumber(node);
+            break;
+    }
+
+    if (!ok) {
+        return false;
+    }
+    node.next = static_cast<uint32_t>(m_nodes.size() + 1);
+    m_nodes.push_back(node);
+    return true;
+}
+
+bool JsonDocument::parseString(Node& node) {
+    // m_pos is on the opening quote
+    size_t start = ++m_pos;
+    const char* data = m_text.data();
+    size_t size = m_text.size();
+    bool escaped = false;
+
+    while (m_pos < size) {
+        // Jump straight to the next quote or backslash; plain runs are the common case
+        const char* hit = static_cast<const char*>(std::memchr(data + m_pos, '"', size - m_pos));
+        size_t quote = hit ? static_cast<size_t>(hit - data) : size;
+        const char* slash = static_cast<const char*>(std::memchr(data + m_pos, '\\', quote - m_pos));
+
+        if (!slash) {
+            if (quote == size) {
+                break;
+            }
+            m_pos = quote + 1;
+            node.type = Type::STRING;
+            node.escaped = escaped;
+            node.start = static_cast<uint32_t>(start);
+            node.length = static_cast<uint32_t>(quote - start);
+            return true;
+        }
+
+        escaped = true;
+        m_pos = static_cast<size_t>(slash - data) + 2;
+    }
+
+    return fail("unterminated string");
+}
+
+bool JsonDocument::parseNumber(Node& node) {
+    size_t start = m_pos;
+    if (m_pos < m_text.size() && m_text[m_pos] == '-') {
+        m_pos++;
+    }
+
+    size_t digits = m_pos;
+    while (m_pos < m_text.size()) {
+        char c = m_text[m_pos];
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+            m_pos++;
+        } else {
+            break;
+        }
+    }
+
+    if (m_pos == digits || m_text[digits] < '0' || m_text[digits] > '9') {
+        return fail("unexpected character");
+    }
+
+    node.type = Type::NUMBER;
+    node.start = static_cast<uint32_t>(start);
+    node.length = static_cast<uint32_t>(m_pos - start);
+    return true;
+}
+
+bool JsonDocument::parseLiteral(const char* literal, Type type) {
+    size_t length = std::strlen(literal);
+    if (m_text.compare(m_pos, length, literal) != 0) {
+        return fail("invalid literal");
+    }
+
+    // Booleans keep their raw text; asBool reads the first character
+    Node node{type, false, static_cast<uint32_t>(m_pos), static_cast<uint32_t>(length), 0, 0};
+    node.next = static_cast<uint32_t>(m_nodes.size() + 1);
+    m_nodes.push_back(node);
+    m_pos += length;
+    return true;
+}
+
+void JsonDocument::skipWhitespace() {
+    while (m_pos < m_text.size()) {
+        char c = m_text[m_pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            break;
+        }
+        m_pos++;
+    }
+}
+
+bool JsonDocument::fail(const std::string& message) {
+    if (m_error.empty()) {
+        m_error = message + " at offset " + std::to_string(m_pos);
+    }
+    return false;
+}
+
+JsonView JsonView::operator[](std::string_view key) const {
+    if (!isObject()) {
+        return JsonView();
+    }
+
+    uint32_t child = m_index + 1;
+    for (uint32_t i = 0; i < node().count; i++) {
+        uint32_t value = child + 1;
+        if (keyEquals(child, key)) {
+            return JsonView(m_document, value);
+        }
+        child = m_document->m_nodes[value].next;
+    }
+    return JsonView();
+}
+
+JsonView JsonView::at(size_t index) const {
+    if (!isArray() || index >= node().count) {
+        return JsonView();
+    }
+
+    uint32_t child = m_index + 1;
+    for (size_t i = 0; i < index; i++) {
+        child = m_document->m_nodes[child].next;
+    }
+    return JsonView(m_document, child);
+}
+
+size_t JsonView::size() const {
+    return (isArray() || isObject()) ? node().count : 0;
+}
+
+std::string JsonView::asString(const std::string& fallback) const {
+    if (!isString()) {
+        return fallback;
+    }
+
+    const JsonDocument::Node& n = node();
+    std::string_view raw(m_document->m_text.data() + n.start, n.length);
+    if (!n.escaped) {
+        return std::string(raw);
+    }
+
+    std::string result;
+    result.reserve(raw.size());
+    appendUnescaped(result, raw);
+    return result;
+}
+
+int64_t JsonView::asInt(int64_t fallback) const {
+    if (!isNumber()) {
+        return fallback;
+    }
+
+    const JsonDocument::Node& n = node();
+    const char* begin = m_document->m_text.data() + n.start;
+    int64_t value = fallback;
+    auto result = std::from_chars(begin, begin + n.length, value);
+    return result.ec == std::errc() ? value : fallback;
+}
+
+bool JsonView::asBool(bool fallback) const {
+    if (!isValid() || node().type != JsonDocument::Type::BOOLEAN) {
+        return fallback;
+    }
+    return m_document->m_text[node().start] == 't';
+}
+
+std::string_view JsonView::raw() const {
+    if (!isValid()) {
+        return std::string_view();
+    }
+
+    const JsonDocument::Node& n = node();
+    if (n.type == JsonDocument::Type::STRING) {
+        return std::string_view(m_document->m_text.data() + n.start - 1, n.length + 2);
+    }
+    return std::string_view(m_document->m_text.data() + n.start, n.length);
+}
+
+std::string_view JsonView::plainString() const {
+    if (!isPlainString()) {
+        return std::string_view();
+    }
+    return std::string_view(m_document->m_text.data() + node().start, node().length);
+}
+
+bool JsonView::keyEquals(uint32_t keyIndex, std::string_view key) const {
+    const JsonDocument::Node& n = m_document->m_nodes[keyIndex];
+    std::string_view raw(m_document->m_text.data() + n.start, n.length);
+    if (!n.escaped) {
+        return raw == key;
+    }
+
+    std::string decoded;
+    appendUnescaped(decoded, raw);
+    return decoded == key;
+}
+
+void JsonView::appendUnescaped(std::string& out, std::string_view escaped) {
+    auto hexValue = [](std::string_view digits, uint32_t& value) {
+        value = 0;
+        for (char c : digits) {
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return false;
+        }
+        return true;
+    };
+
+    auto appendUtf8 = [&out](uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            out += static_cast<char>(codepoint);
+        } else if (codepoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    };
+
+    size_t i = 0;
+    while (i < escaped.size()) {
+        // Copy the run up to the next escape in one go
+        size_t slash = escaped.find('\\', i);
+        if (slash == std::string_view::npos) {
+            out.append(escaped.data() + i, escaped.size() - i);
+            return;
+        }
+        out.append(escaped.data() + i, slash - i);
+        if (slash + 1 >= escaped.size()) {
+            return;
+        }
+
+        char c = escaped[slash + 1];
+        i = slash + 2;
+        switch (c) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+                uint32_t codepoint;
+                if (i + 4 > escaped.size() || !hexValue(escaped.substr(i, 4), codepoint)) {
+                    break;
+                }
+                i += 4;
+
+                // UTF-16 surrogate pair
+                uint32_t low;
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF && i + 6 <= escaped.size() &&
+                    escaped[i] == '\\' && escaped[i + 1] == 'u' && hexValue(escaped.substr(i + 2, 4), low) &&
+                    low >= 0xDC00 && low <= 0xDFFF) {
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                }
+                appendUtf8(codepoint);
+                break;
+            }
+            default:
+                // \" \\ \/ and anything unknown stand for themselves
+                out += c;
+                break;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef JSONREADER_HPP
+#define JSONREADER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+class JsonView;
+
+// Single-pass JSON tokenizer. The message text is kept as-is and parsed into a
+// flat tape of nodes that point back into it, so strings without escapes and
+// numbers are never copied; values are decoded only when a handler asks.
+class JsonDocument {
+public:
+    enum class Type : uint8_t {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    struct Node {
+        Type type;
+        bool escaped;     // STRING: contains backslash escapes
+        uint32_t start;   // offset of the value (inside the quotes for strings)
+        uint32_t length;  // raw length; for containers the span including brackets
+        uint32_t count;   // ARRAY: elements, OBJECT: members
+        uint32_t next;    // tape index just past this value's subtree
+    };
+
+    JsonDocument() = default;
+
+    // Takes ownership of the text; false (with getError()) on malformed input
+    bool parse(std::string text);
+
+    JsonView root() const;
+    const std::string& getText() const { return m_text; }
+    const std::string& getError() const { return m_error; }
+
+private:
+    friend class JsonView;
+
+    static const int MAX_DEPTH = 128;
+
+    std::string m_text;
+    std::vector<Node> m_nodes;
+    std::string m_error;
+    size_t m_pos = 0;
+
+    bool parseValue(int depth);
+    bool parseString(Node& node);
+    bool parseNumber(Node& node);
+    bool parseLiteral(const char* literal, Type type);
+    void skipWhitespace();
+    bool fail(const std::string& message);
+};
+
+// Read-only handle to one value of a JsonDocument. Missing keys and indexes
+// yield an invalid view whose accessors return the supplied defaults, so
+// optional LSP fields can be read without checking every level.
+class JsonView {
+public:
+    JsonView() : m_document(nullptr), m_index(0) {}
+    JsonView(const JsonDocument* document, uint32_t index) : m_document(document), m_index(index) {}
+
+    bool isValid() const { return m_document != nullptr; }
+    bool isNull() const { return isValid() && node().type == JsonDocument::Type::NUL; }
+    bool isString() const { return isValid() && node().type == JsonDocument::Type::STRING; }
+    bool isNumber() const { return isValid() && node().type == JsonDocument::Type::NUMBER; }
+    bool isArray() const { return isValid() && node().type == JsonDocument::Type::ARRAY; }
+    bool isObject() const { return isValid() && node().type == JsonDocument::Type::OBJECT; }
+
+    // Object member / array element lookup
+    JsonView operator[](std::string_view key) const;
+    JsonView at(size_t index) const;
+    size_t size() const;
+
+    // Call visit(JsonView element) for each array element
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        if (!isArray()) {
+            return;
+        }
+        uint32_t child = m_index + 1;
+        for (uint32_t i = 0; i < node().count; i++) {
+            visit(JsonView(m_document, child));
+            child = m_document->m_nodes[child].next;
+        }
+    }
+
+    std::string asString(const std::string& fallback = "") const;
+    int64_t asInt(int64_t fallback = 0) const;
+    bool asBool(bool fallback = false) const;
+
+    // Raw JSON text of the value, e.g. to echo a request id back unchanged
+    std::string_view raw() const;
+
+    // Unescaped string contents without copying; only valid for strings with
+    // no escapes (check with isPlainString)
+    bool isPlainString() const { return isString() && !node().escaped; }
+    std::string_view plainString() const;
+
+private:
+    const JsonDocument* m_document;
+    uint32_t m_index;
+
+    const JsonDocument::Node& node() const { return m_document->m_nodes[m_index]; }
+    bool keyEquals(uint32_t keyIndex, std::string_view key) const;
+    static void appendUnescaped(std::string& out, std::string_view escaped);
+};
+
+#endif // JSONREADER_HPP
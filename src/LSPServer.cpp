@@ -1,29 +1,144 @@
 #include "LSPServer.hpp"
 #include "FileScanner.hpp"
 #include <iostream>
-#include <sstream>
-#include <regex>
+#include <fstream>
+#include <set>
+#include <tuple>
 #include <filesystem>
+#include <chrono>
+#include <algorithm>
 
 namespace fs = std::filesystem;
 
-LSPServer::LSPServer() : m_index(std::make_unique<SymbolIndex>()), m_exporter(std::make_unique<JsonExporter>()) {
+namespace {
+
+LSPPosition readPosition(JsonView position) {
+    LSPPosition result;
+    result.line = static_cast<int>(position["line"].asInt(0));
+    result.character = static_cast<int>(position["character"].asInt(0));
+    return result;
+}
+
+// Plain-text "symbols" are words and lines, not definitions
+bool isTextSymbol(SymbolType type) {
+    return type >= SymbolType::TXT_HEADER && type <= SymbolType::TXT_WORD;
+}
+
+void appendRange(std::string& out, uint32_t line, uint32_t startCharacter, uint32_t endCharacter) {
+    std::string l = std::to_string(line);
+    out += "{\"start\":{\"line\":" + l + ",\"character\":" + std::to_string(startCharacter) + "},";
+    out += "\"end\":{\"line\":" + l + ",\"character\":" + std::to_string(endCharacter) + "}}";
+}
+
+void appendLocation(std::string& out, const std::string& path, uint32_t line,
+                    uint32_t startCharacter, uint32_t endCharacter) {
+    out += "{\"uri\":\"file://";
+    JsonExporter::appendEscaped(out, path);
+    out += "\",\"range\":";
+    appendRange(out, line, startCharacter, endCharacter);
+    out += '}';
+}
+
+} // namespace
+
+std::string LSPParams::uri() const {
+    return m_params["textDocument"]["uri"].asString();
+}
+
+int64_t LSPParams::version() const {
+    return m_params["textDocument"]["version"].asInt(0);
+}
+
+std::string LSPParams::text() const {
+    return m_params["textDocument"]["text"].asString();
+}
+
+LSPPosition LSPParams::position() const {
+    return readPosition(m_params["position"]);
+}
+
+std::string LSPParams::query() const {
+    return m_params["query"].asString();
+}
+
+bool LSPParams::includeDeclaration() const {
+    return m_params["context"]["includeDeclaration"].asBool(true);
+}
+
+std::string LSPParams::rootUri() const {
+    JsonView rootUri = m_params["rootUri"];
+    if (rootUri.isString()) {
+        return rootUri.asString();
+    }
+    return m_params["rootPath"].asString();
+}
+
+JsonView LSPParams::contentChanges() const {
+    return m_params["contentChanges"];
+}
+
+JsonView LSPParams::changes() const {
+    return m_params["changes"];
+}
+
+LSPServer::LSPServer()
+    : m_running(false)
+    , m_exporter(std::make_unique<JsonExporter>())
+    , m_host(std::make_shared<IndexHost>())
+    , m_sharedHost(false)
+    , m_ownQueryPool(std::make_unique<ThreadPool>(defaultQueryThreadCount()))
+    , m_queryPool(*m_ownQueryPool)
+{
+    // Only the client that owns the index hears about its progress
+    m_host->setProgressCallback([this](const std::string& kind, const std::string& message, int percentage) {
+        reportProgress(kind, message, percentage);
+    });
+    m_host->setLogCallback([this](const std::string& message) { logMessage(message); });
+    initializeHandlers();
+}
+
+LSPServer::LSPServer(std::shared_ptr<IndexHost> host, int inputFd, int outputFd, ThreadPool& queryPool)
+    : m_running(false)
+    , m_exporter(std::make_unique<JsonExporter>())
+    , m_transport(inputFd, outputFd)
+    , m_host(std::move(host))
+    , m_sharedHost(true)
+    , m_queryPool(queryPool)
+{
     initializeHandlers();
 }
 
+size_t LSPServer::defaultQueryThreadCount() {
+    return std::max(2u, std::thread::hardware_concurrency() / 2);
+}
+
+LSPServer::~LSPServer() {
+    if (!m_sharedHost) {
+        m_host->stopIndexing();
+    }
+    waitForQueries();
+    stopWriter();
+}
+
 void LSPServer::start() {
     m_running = true;
+    m_writerStopping = false;
+    m_writer = std::thread([this]() { writerLoop(); });
     logMessage("LSP Server started");
     
-    std::string line;
-    while (m_running && std::getline(std::cin, line)) {
-        if (line.empty()) continue;
-        
-        std::string response = processMessage(line);
-        if (!response.empty()) {
-            std::cout << response << std::endl;
-        }
+    std::string message;
+    while (m_running && m_transport.readMessage(message)) {
+        dispatchMessage(std::move(message));
     }
+    
+    // Let queries already running answer before the output closes
+    if (m_sharedHost) {
+        closeAllDocuments();
+    } else {
+        m_host->stopIndexing();
+    }
+    waitForQueries();
+    stopWriter();
 }
 
 void LSPServer::stop() {
@@ -31,15 +146,21 @@ void LSPServer::stop() {
     logMessage("LSP Server stopped");
 }
 
-std::string LSPServer::processMessage(const std::string& message) {
-    try {
-        LSPRequest request = parseRequest(message);
-        LSPResponse response = processRequest(request);
-        return formatResponse(response);
-    } catch (const std::exception& e) {
-        logMessage("Error processing message: " + std::string(e.what()));
-        return formatError("", -32700, "Parse error");
+std::string LSPServer::processMessage(std::string message) {
+    LSPRequest request;
+    std::string error;
+    if (!parseRequest(std::move(message), request, error)) {
+        logMessage("Error parsing message: " + error);
+        return formatError("", -32700, "Parse error: " + error).str();
+    }
+    
+    LSPResponse response = processRequest(request);
+    
+    // Notifications never get a reply, not even an error
+    if (request.isNotification()) {
+        return "";
     }
+    return formatResponse(std::move(response)).str();
 }
 
 LSPResponse LSPServer::processRequest(const LSPRequest& request) {
@@ -47,30 +168,164 @@ LSPResponse LSPServer::processRequest(const LSPRequest& request) {
     response.id = request.id;
     
     auto handler = m_handlers.find(request.method);
-    if (handler != m_handlers.end()) {
-        try {
+    auto query = m_queryHandlers.find(request.method);
+    try {
+        if (handler != m_handlers.end()) {
             response.result = handler->second(request.params);
+        } else if (query != m_queryHandlers.end()) {
+            CancellationToken token;
+            m_host->waitForGeneration(m_lastPublish);
+            response.result = query->second(request.params, token);
+        } else {
+            response.error = "Method not found: " + request.method;
+            response.errorCode = -32601;
+        }
+    } catch (const std::exception& e) {
+        response.error = "Internal error: " + std::string(e.what());
+        response.errorCode = -32603;
+    }
+    
+    return response;
+}
+
+void LSPServer::dispatchMessage(std::string message) {
+    auto request = std::make_shared<LSPRequest>();
+    std::string error;
+    if (!parseRequest(std::move(message), *request, error)) {
+        logMessage("Error parsing message: " + error);
+        sendMessage(formatError("", -32700, "Parse error: " + error));
+        return;
+    }
+    
+    // Replies to our own requests (window/workDoneProgress/create) need no answer
+    if (request->method.empty() && !request->isNotification()) {
+        handleProgressCreated(*request);
+        return;
+    }
+    
+    auto query = m_queryHandlers.find(request->method);
+    if (query == m_queryHandlers.end() || request->isNotification()) {
+        // State changes run here, in the order the client sent them
+        LSPResponse response = processRequest(*request);
+        if (!request->isNotification()) {
+            sendMessage(formatResponse(std::move(response)));
+        }
+        return;
+    }
+    
+    auto token = std::make_shared<CancellationToken>();
+    {
+        std::lock_guard<std::mutex> lock(m_queriesMutex);
+        m_queries[request->id] = token;
+    }
+    
+    const QueryHandler& handler = query->second;
+    uint64_t generation = m_lastPublish;
+    m_queryPool.enqueue([this, request, &handler, generation, token]() {
+        runQuery(request, handler, generation, token);
+    });
+}
+
+void LSPServer::runQuery(const std::shared_ptr<LSPRequest>& request, const QueryHandler& handler, uint64_t generation,
+                         const std::shared_ptr<CancellationToken>& token) {
+    LSPResponse response;
+    response.id = request->id;
+    
+    // Answer from an index that has every edit sent before this request.
+    // Cancelled while queued or waiting: skip the work entirely
+    if (m_host->waitForGeneration(generation, token.get()) && !token->isCancelled()) {
+        try {
+            response.result = handler(request->params, *token);
         } catch (const std::exception& e) {
             response.error = "Internal error: " + std::string(e.what());
+            response.errorCode = -32603;
         }
-    } else {
-        response.error = "Method not found: " + request.method;
     }
     
-    return response;
+    if (token->isCancelled()) {
+        response.result.clear();
+        response.error = "Request cancelled";
+        response.errorCode = -32800;
+    }
+    
+    sendMessage(formatResponse(std::move(response)));
+    finishQuery(request->id);
+}
+
+void LSPServer::finishQuery(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m_queriesMutex);
+    m_queries.erase(id);
+    if (m_queries.empty()) {
+        m_queriesDone.notify_all();
+    }
+}
+
+void LSPServer::waitForQueries() {
+    std::unique_lock<std::mutex> lock(m_queriesMutex);
+    m_queriesDone.wait(lock, [this]() { return m_queries.empty(); });
+}
+
+void LSPServer::sendMessage(OutgoingMessage message) {
+    {
+        std::lock_guard<std::mutex> lock(m_outboxMutex);
+        if (!m_writer.joinable()) {
+            // Not serving (e.g. processMessage callers); write directly
+            m_transport.writeMessage(message);
+            return;
+        }
+        m_outbox.push_back(std::move(message));
+    }
+    m_outboxCondition.notify_one();
+}
+
+void LSPServer::writerLoop() {
+    std::deque<OutgoingMessage> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_outboxMutex);
+            m_outboxCondition.wait(lock, [this]() { return m_writerStopping || !m_outbox.empty(); });
+            if (m_outbox.empty()) {
+                return;
+            }
+            batch.swap(m_outbox);
+        }
+        
+        // Responses go out in the order they were completed
+        for (const auto& message : batch) {
+            m_transport.writeMessage(message);
+        }
+        batch.clear();
+    }
+}
+
+void LSPServer::stopWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_outboxMutex);
+        m_writerStopping = true;
+    }
+    m_outboxCondition.notify_all();
+    
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
 }
 
-std::string LSPServer::handleInitialize(const std::map<std::string, std::string>& params) {
-    std::string rootUri = extractParam(params, "rootUri");
+std::string LSPServer::handleInitialize(const LSPParams& params) {
+    std::string rootUri = params.rootUri();
     if (!rootUri.empty()) {
-        m_workspaceRoot = uriToPath(rootUri);
-        logMessage("Workspace root: " + m_workspaceRoot);
+        std::string root = uriToPath(rootUri);
+        if (m_host->setRoot(root)) {
+            logMessage("Workspace root: " + root);
+        } else {
+            logMessage("Already serving " + m_host->getRoot() + ", ignoring root " + root);
+        }
     }
+    m_workDoneProgress = params.json()["capabilities"]["window"]["workDoneProgress"].asBool(false);
     
     // Return server capabilities
     return R"({
         "capabilities": {
-            "textDocumentSync": 1,
+            "textDocumentSync": 2,
             "documentSymbolProvider": true,
             "workspaceSymbolProvider": true,
             "definitionProvider": true,
@@ -84,229 +339,512 @@ std::string LSPServer::handleInitialize(const std::map<std::string, std::string>
     })";
 }
 
-std::string LSPServer::handleInitialized(const std::map<std::string, std::string>& params) {
+std::string LSPServer::handleInitialized(const LSPParams& params) {
     m_initialized = true;
     
-    // Build initial index
-    if (!m_workspaceRoot.empty()) {
-        rebuildIndex();
-    }
+    // Index in the background; queries answer from whatever has been published
+    m_host->ensureIndexed();
     
     logMessage("LSP Server initialized");
     return "null";
 }
 
-std::string LSPServer::handleShutdown(const std::map<std::string, std::string>& params) {
+std::string LSPServer::handleShutdown(const LSPParams& params) {
     logMessage("Shutdown requested");
     return "null";
 }
 
-std::string LSPServer::handleExit(const std::map<std::string, std::string>& params) {
+std::string LSPServer::handleExit(const LSPParams& params) {
     stop();
     return "";
 }
 
-std::string LSPServer::handleTextDocumentDidOpen(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
+std::string LSPServer::handleTextDocumentDidOpen(const LSPParams& params) {
+    std::string uri = params.uri();
     std::string filePath = uriToPath(uri);
     
     if (!filePath.empty()) {
-        updateFile(filePath);
+        if (params.json()["textDocument"]["text"].isString()) {
+            std::string text = params.text();
+            {
+                std::lock_guard<std::mutex> lock(m_documentsMutex);
+                if (!m_documents.isOpen(filePath)) {
+                    m_host->markOpen(filePath);
+                }
+                m_documents.open(filePath, text, params.version());
+            }
+            updateDocument(filePath, text);
+        } else {
+            updateFile(filePath);
+        }
         logMessage("Document opened: " + filePath);
     }
     
     return "";
 }
 
-std::string LSPServer::handleTextDocumentDidChange(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
+std::string LSPServer::handleTextDocumentDidChange(const LSPParams& params) {
+    std::string uri = params.uri();
     std::string filePath = uriToPath(uri);
     
-    if (!filePath.empty()) {
+    if (filePath.empty()) {
+        return "";
+    }
+    
+    // Queries read lines of open documents from worker threads
+    std::unique_lock<std::mutex> lock(m_documentsMutex);
+    TextDocument* document = m_documents.find(filePath);
+    
+    // Changes apply in order; a change without a range replaces the whole text
+    bool applied = true;
+    params.contentChanges().forEach([&](JsonView change) {
+        JsonView range = change["range"];
+        if (!range.isValid()) {
+            if (document) {
+                document->setText(change["text"].asString());
+            } else {
+                m_host->markOpen(filePath);
+                document = &m_documents.open(filePath, change["text"].asString(), params.version());
+            }
+        } else if (document) {
+            LSPPosition start = readPosition(range["start"]);
+            LSPPosition end = readPosition(range["end"]);
+            document->replace(start.line, start.character, end.line, end.character, change["text"].asString());
+        } else {
+            applied = false;
+        }
+    });
+    
+    // A ranged edit to a document we never saw opened has nothing to apply to
+    if (!document || !applied) {
+        lock.unlock();
         updateFile(filePath);
-        logMessage("Document changed: " + filePath);
+        logMessage("Document changed without an open buffer, reindexed from disk: " + filePath);
+        return "";
     }
     
+    document->setVersion(params.version());
+    std::string text = document->getText();
+    lock.unlock();
+    
+    updateDocument(filePath, text);
+    logMessage("Document changed: " + filePath + " (version " + std::to_string(params.version()) + ")");
+    
     return "";
 }
 
-std::string LSPServer::handleTextDocumentDidClose(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
-    logMessage("Document closed: " + uriToPath(uri));
+std::string LSPServer::handleTextDocumentDidClose(const LSPParams& params) {
+    std::string uri = params.uri();
+    std::string filePath = uriToPath(uri);
+    
+    // Unsaved edits are discarded with the buffer; the file on disk is authoritative again
+    bool wasOpen;
+    {
+        std::lock_guard<std::mutex> lock(m_documentsMutex);
+        wasOpen = m_documents.isOpen(filePath);
+        m_documents.close(filePath);
+    }
+    if (wasOpen) {
+        m_host->markClosed(filePath);
+        updateFile(filePath);
+    }
+    
+    logMessage("Document closed: " + filePath);
     return "";
 }
 
-std::string LSPServer::handleTextDocumentDocumentSymbol(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
+std::string LSPServer::handleTextDocumentDocumentSymbol(const LSPParams& params, const CancellationToken& cancel) {
+    std::string uri = params.uri();
     std::string filePath = uriToPath(uri);
     
-    if (!filePath.empty() && m_index) {
-        return m_exporter->exportDocumentSymbols(*m_index, filePath);
+    auto index = acquireIndex();
+    if (filePath.empty() || !index) {
+        return "[]";
     }
     
-    return "[]";
+    // Editors ask again on every focus change; the answer only moves when the file does
+    std::string json;
+    if (index->findCachedOutline(filePath, json)) {
+        return json;
+    }
+    
+    json = m_exporter->exportDocumentSymbols(index->getSymbols(), filePath, &cancel);
+    if (!cancel.isCancelled()) {
+        index->cacheOutline(filePath, json);
+    }
+    return json;
 }
 
-std::string LSPServer::handleWorkspaceSymbol(const std::map<std::string, std::string>& params) {
-    std::string query = extractParam(params, "query");
+std::string LSPServer::handleWorkspaceSymbol(const LSPParams& params, const CancellationToken& cancel) {
+    std::string query = params.query();
     
-    if (m_index) {
-        return m_exporter->exportWorkspaceSymbols(*m_index, query);
+    auto index = acquireIndex();
+    if (!index) {
+        return "[]";
     }
     
-    return "[]";
+    // Ranked through the completion engine's prefix, acronym and fuzzy tiers
+    // and capped, so a one-letter query cannot produce a huge response
+    std::vector<AutocompleteResult> results;
+    if (query.empty()) {
+        const SymbolIndex& symbols = index->getSymbols();
+        results.reserve(std::min(symbols.size(), WORKSPACE_SYMBOL_LIMIT));
+        for (FileId file = 0; file < symbols.getFileCount() && results.size() < WORKSPACE_SYMBOL_LIMIT; file++) {
+            for (const Symbol& symbol : symbols.getFileSymbols(file)) {
+                if (results.size() == WORKSPACE_SYMBOL_LIMIT) {
+                    break;
+                }
+                results.emplace_back(symbol.name, symbol.type, symbol.file, symbol.line, 0.0, symbol.context, "");
+            }
+        }
+    } else {
+        results = index->getCompletions().getCompletions(query, WORKSPACE_SYMBOL_LIMIT);
+    }
+    
+    if (cancel.isCancelled()) {
+        return "[]";
+    }
+    return m_exporter->exportSymbolInformation(results);
 }
 
-std::string LSPServer::handleWorkspaceDidChangeWatchedFiles(const std::map<std::string, std::string>& params) {
-    // Rebuild index when files change
-    rebuildIndex();
-    logMessage("Workspace files changed, index rebuilt");
+std::string LSPServer::handleWorkspaceDidChangeWatchedFiles(const LSPParams& params) {
+    // FileChangeType: 1 = created, 2 = changed, 3 = deleted
+    const ExtensionSet& extensions = FileScanner::getSupportedExtensions();
+    size_t updated = 0;
+    
+    params.changes().forEach([&](JsonView change) {
+        std::string filePath = uriToPath(change["uri"].asString());
+        // Open documents are tracked through their buffers, not the disk
+        if (filePath.empty() || !extensions.matches(filePath) || m_documents.isOpen(filePath)) {
+            return;
+        }
+        
+        if (change["type"].asInt(2) == 3) {
+            removeFile(filePath);
+        } else {
+            updateFile(filePath);
+        }
+        updated++;
+    });
+    
+    logMessage("Workspace files changed, " + std::to_string(updated) + " file(s) reindexed");
     return "";
 }
 
-std::string LSPServer::handleTextDocumentDefinition(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
-    std::string position = extractParam(params, "position");
+std::string LSPServer::handleTextDocumentDefinition(const LSPParams& params, const CancellationToken& cancel) {
+    int startCharacter = 0;
+    std::string identifier = identifierAt(uriToPath(params.uri()), params.position(), startCharacter);
+    if (identifier.empty()) {
+        return "[]";
+    }
     
-    // For now, return empty array - would need more sophisticated implementation
-    logMessage("Definition requested for: " + uri + " at " + position);
-    return "[]";
+    auto index = acquireIndex();
+    std::string json = "[";
+    bool first = true;
+    std::set<std::tuple<std::string, uint32_t, uint32_t>> seen;
+    for (const Symbol& symbol : index->getSymbols().exactSearch(identifier)) {
+        if (cancel.isCancelled()) {
+            return "[]";
+        }
+        if (isTextSymbol(symbol.type)) {
+            continue;
+        }
+        
+        // Symbols only know their line; the identifier index knows the column
+        uint32_t line = symbol.line > 0 ? static_cast<uint32_t>(symbol.line - 1) : 0;
+        auto occurrences = index->getIdentifiers().findOnLine(identifier, symbol.file, line);
+        uint32_t character = occurrences.empty() ? 0 : occurrences.front().character;
+        
+        // Several symbols on one line (an import and its alias, say) are one location
+        if (!seen.emplace(symbol.file, line, character).second) {
+            continue;
+        }
+        
+        if (!first) {
+            json += ',';
+        }
+        first = false;
+        appendLocation(json, symbol.file, line, character, character + static_cast<uint32_t>(identifier.size()));
+    }
+    json += ']';
+    return json;
 }
 
-std::string LSPServer::handleTextDocumentReferences(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
-    std::string position = extractParam(params, "position");
+std::string LSPServer::handleTextDocumentReferences(const LSPParams& params, const CancellationToken& cancel) {
+    int startCharacter = 0;
+    std::string identifier = identifierAt(uriToPath(params.uri()), params.position(), startCharacter);
+    if (identifier.empty()) {
+        return "[]";
+    }
+    
+    auto index = acquireIndex();
+    const IdentifierIndex& identifiers = index->getIdentifiers();
+    auto locations = identifiers.find(identifier, REFERENCES_LIMIT, &cancel);
+    if (cancel.isCancelled()) {
+        return "[]";
+    }
     
-    // For now, return empty array - would need more sophisticated implementation
-    logMessage("References requested for: " + uri + " at " + position);
-    return "[]";
+    // Without the declaration, drop occurrences on the lines that define the name
+    std::set<std::pair<std::string, uint32_t>> declarations;
+    if (!params.includeDeclaration()) {
+        for (const Symbol& symbol : index->getSymbols().exactSearch(identifier)) {
+            if (!isTextSymbol(symbol.type) && symbol.line > 0) {
+                declarations.emplace(symbol.file, static_cast<uint32_t>(symbol.line - 1));
+            }
+        }
+    }
+    
+    std::string json = "[";
+    bool first = true;
+    for (const auto& location : locations) {
+        const std::string& filePath = identifiers.getFilePath(location.file);
+        if (!declarations.empty() && declarations.count({filePath, location.position.line})) {
+            continue;
+        }
+        
+        if (!first) {
+            json += ',';
+        }
+        first = false;
+        appendLocation(json, filePath, location.position.line, location.position.character,
+                       location.position.character + static_cast<uint32_t>(identifier.size()));
+    }
+    json += ']';
+    return json;
 }
 
-std::string LSPServer::handleTextDocumentHover(const std::map<std::string, std::string>& params) {
-    std::string uri = extractParam(params, "uri");
-    std::string position = extractParam(params, "position");
+std::string LSPServer::handleTextDocumentHover(const LSPParams& params, const CancellationToken& cancel) {
+    LSPPosition position = params.position();
+    int startCharacter = 0;
+    std::string identifier = identifierAt(uriToPath(params.uri()), position, startCharacter);
+    if (identifier.empty()) {
+        return "null";
+    }
     
-    // For now, return null - would need more sophisticated implementation
-    logMessage("Hover requested for: " + uri + " at " + position);
-    return "null";
+    auto index = acquireIndex();
+    const SymbolIndex& symbols = index->getSymbols();
+    std::string value;
+    size_t shown = 0;
+    for (const Symbol& symbol : symbols.exactSearch(identifier)) {
+        if (shown == HOVER_DEFINITION_LIMIT || cancel.isCancelled()) {
+            break;
+        }
+        if (isTextSymbol(symbol.type)) {
+            continue;
+        }
+        
+        if (shown > 0) {
+            value += "\n\n---\n\n";
+        }
+        if (!symbol.context.empty()) {
+            value += "```\n" + symbol.context + "\n```\n\n";
+        }
+        value += "*" + symbols.symbolTypeToString(symbol.type) + "* " +
+                 fs::path(symbol.file).filename().string() + ":" + std::to_string(symbol.line);
+        shown++;
+    }
+    if (shown == 0) {
+        return "null";
+    }
+    
+    std::string json = "{\"contents\":{\"kind\":\"markdown\",\"value\":\"";
+    JsonExporter::appendEscaped(json, value);
+    json += "\"},\"range\":";
+    appendRange(json, static_cast<uint32_t>(position.line), static_cast<uint32_t>(startCharacter),
+                static_cast<uint32_t>(startCharacter) + static_cast<uint32_t>(identifier.size()));
+    json += '}';
+    return json;
+}
+
+std::string LSPServer::handleCancelRequest(const LSPParams& params) {
+    std::string id(params.json()["id"].raw());
+    
+    std::lock_guard<std::mutex> lock(m_queriesMutex);
+    auto query = m_queries.find(id);
+    if (query != m_queries.end()) {
+        query->second->cancel();
+        logMessage("Cancelled request " + id);
+    }
+    return "";
 }
 
 void LSPServer::setWorkspaceRoot(const std::string& root) {
-    m_workspaceRoot = root;
-    rebuildIndex();
+    // Indexing starts once the client sends initialized
+    m_host->setRoot(root);
 }
 
-void LSPServer::rebuildIndex() {
-    if (m_workspaceRoot.empty() || !m_index) return;
-    
-    logMessage("Rebuilding symbol index for: " + m_workspaceRoot);
-    
-    auto files = FileScanner::scanForAllSupportedFiles(m_workspaceRoot);
-    m_index->clear();
-    m_index->buildIndex(files);
-    
-    logMessage("Index rebuilt with " + std::to_string(m_index->size()) + " symbols");
+void LSPServer::startIndexing() {
+    m_host->startIndexing();
 }
 
-void LSPServer::updateFile(const std::string& filePath) {
-    if (!m_index || !fs::exists(filePath)) return;
-    
-    // For now, just rebuild the entire index
-    // A more sophisticated implementation would update only the specific file
-    rebuildIndex();
+void LSPServer::stopIndexing() {
+    m_host->stopIndexing();
 }
 
-LSPRequest LSPServer::parseRequest(const std::string& message) const {
-    LSPRequest request;
+void LSPServer::rebuildIndex() {
+    m_host->rebuild();
+}
+
+void LSPServer::reportProgress(const std::string& kind, const std::string& message, int percentage) {
+    if (!m_workDoneProgress) {
+        return;
+    }
     
-    // Simple JSON parsing - in production, use a proper JSON library
-    std::regex methodRegex("\"method\"\\s*:\\s*\"([^\"]+)\"");
-    std::regex idRegex("\"id\"\\s*:\\s*\"?([^\",}]+)\"?");
-    std::regex paramsRegex("\"params\"\\s*:\\s*\\{([^}]*)\\}");
+    std::lock_guard<std::mutex> lock(m_progressMutex);
     
-    std::smatch match;
+    // A fresh token per scan, created on the client before it is used
+    if (kind == "begin") {
+        m_progressToken = "navix/indexing/" + std::to_string(++m_progressCount);
+        m_progressState = ProgressState::CREATING;
+        m_heldProgress.clear();
+        sendMessage("{\"jsonrpc\":\"2.0\",\"id\":\"" + m_progressToken + "\",\"method\":\"window/workDoneProgress/create\","
+                    "\"params\":{\"token\":\"" + m_progressToken + "\"}}");
+    }
+    if (m_progressState == ProgressState::REFUSED) {
+        return;
+    }
     
-    if (std::regex_search(message, match, methodRegex)) {
-        request.method = match[1].str();
+    std::string value = "{\"kind\":\"" + kind + "\"";
+    if (kind == "begin") {
+        value += ",\"cancellable\":false,\"title\":\"";
+        JsonExporter::appendEscaped(value, message);
+        value += '"';
+    } else if (!message.empty()) {
+        value += ",\"message\":\"";
+        JsonExporter::appendEscaped(value, message);
+        value += '"';
     }
+    if (percentage >= 0 && kind != "end") {
+        value += ",\"percentage\":" + std::to_string(percentage);
+    }
+    value += '}';
     
-    if (std::regex_search(message, match, idRegex)) {
-        request.id = match[1].str();
+    std::string notification = "{\"jsonrpc\":\"2.0\",\"method\":\"$/progress\",\"params\":{\"token\":\"" +
+                               m_progressToken + "\",\"value\":" + value + "}}";
+    if (m_progressState == ProgressState::CREATING) {
+        m_heldProgress.push_back(std::move(notification));
+    } else {
+        sendMessage(std::move(notification));
+    }
+}
+
+void LSPServer::handleProgressCreated(const LSPRequest& reply) {
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    if (m_progressState != ProgressState::CREATING || reply.id != "\"" + m_progressToken + "\"") {
+        return;
     }
     
-    if (std::regex_search(message, match, paramsRegex)) {
-        std::string paramsStr = match[1].str();
-        
-        // Parse common parameters
-        std::regex uriRegex("\"uri\"\\s*:\\s*\"([^\"]+)\"");
-        std::regex queryRegex("\"query\"\\s*:\\s*\"([^\"]+)\"");
-        std::regex rootUriRegex("\"rootUri\"\\s*:\\s*\"([^\"]+)\"");
-        std::regex positionRegex("\"position\"\\s*:\\s*\\{[^}]*\"line\"\\s*:\\s*(\\d+)[^}]*\"character\"\\s*:\\s*(\\d+)[^}]*\\}");
-        
-        if (std::regex_search(paramsStr, match, uriRegex)) {
-            request.params["uri"] = match[1].str();
-        }
-        if (std::regex_search(paramsStr, match, queryRegex)) {
-            request.params["query"] = match[1].str();
-        }
-        if (std::regex_search(paramsStr, match, rootUriRegex)) {
-            request.params["rootUri"] = match[1].str();
+    // An error reply means the client will not show this token
+    if (reply.document->root()["error"].isValid()) {
+        m_progressState = ProgressState::REFUSED;
+    } else {
+        m_progressState = ProgressState::READY;
+        for (auto& notification : m_heldProgress) {
+            sendMessage(std::move(notification));
         }
-        if (std::regex_search(paramsStr, match, positionRegex)) {
-            request.params["position"] = match[1].str() + ":" + match[2].str();
+    }
+    m_heldProgress.clear();
+}
+
+void LSPServer::closeAllDocuments() {
+    // A client that goes away without didClose leaves the disk authoritative again
+    std::vector<std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(m_documentsMutex);
+        paths = m_documents.getPaths();
+        for (const auto& path : paths) {
+            m_documents.close(path);
         }
     }
-    
-    return request;
+    for (const auto& path : paths) {
+        m_host->markClosed(path);
+        updateFile(path);
+    }
 }
 
-std::string LSPServer::formatResponse(const LSPResponse& response) const {
-    std::ostringstream json;
-    
-    json << "{";
-    json << "\"jsonrpc\":\"" << response.jsonrpc << "\"";
-    
-    if (!response.id.empty()) {
-        json << ",\"id\":\"" << response.id << "\"";
+void LSPServer::updateFile(const std::string& filePath) {
+    std::error_code ec;
+    if (!fs::is_regular_file(filePath, ec)) {
+        removeFile(filePath);
+        return;
     }
     
-    if (!response.error.empty()) {
-        json << ",\"error\":{\"code\":-32603,\"message\":\"" << response.error << "\"}";
-    } else {
-        json << ",\"result\":" << response.result;
+    // Parse just this file and swap its symbols in; the rest of the index is
+    // untouched. A buffer some client still has open wins over the disk
+    m_lastPublish = m_host->publishFromDisk({filePath});
+}
+
+void LSPServer::updateDocument(const std::string& filePath, const std::string& text) {
+    m_lastPublish = m_host->publish({WorkspaceIndex::FileUpdate::fromText(filePath, text)});
+}
+
+void LSPServer::removeFile(const std::string& filePath) {
+    m_lastPublish = m_host->publish({WorkspaceIndex::FileUpdate::removal(filePath)}, true);
+    logMessage("Removed symbols for " + filePath);
+}
+
+std::shared_ptr<const WorkspaceIndex> LSPServer::acquireIndex() const {
+    return m_host->acquire();
+}
+
+bool LSPServer::parseRequest(std::string message, LSPRequest& request, std::string& error) const {
+    request.document = std::make_shared<JsonDocument>();
+    if (!request.document->parse(std::move(message))) {
+        error = request.document->getError();
+        return false;
     }
     
-    json << "}";
+    JsonView root = request.document->root();
+    if (!root.isObject()) {
+        error = "message is not a JSON object";
+        return false;
+    }
     
-    return json.str();
+    request.method = root["method"].asString();
+    JsonView id = root["id"];
+    if (id.isValid() && !id.isNull()) {
+        request.id = std::string(id.raw());
+    }
+    request.params = LSPParams(root["params"]);
+    return true;
 }
 
-std::string LSPServer::formatError(const std::string& id, int code, const std::string& message) const {
-    std::ostringstream json;
-    
-    json << "{";
-    json << "\"jsonrpc\":\"2.0\"";
-    
-    if (!id.empty()) {
-        json << ",\"id\":\"" << id << "\"";
-    } else {
-        json << ",\"id\":null";
+OutgoingMessage LSPServer::formatResponse(LSPResponse response) const {
+    if (!response.error.empty()) {
+        return formatError(response.id, response.errorCode ? response.errorCode : -32603, response.error);
     }
     
-    json << ",\"error\":{\"code\":" << code << ",\"message\":\"" << message << "\"}";
-    json << "}";
-    
-    return json.str();
+    OutgoingMessage message;
+    message.prefix.reserve(64);
+    message.prefix += "{\"jsonrpc\":\"";
+    message.prefix += response.jsonrpc;
+    message.prefix += "\",\"id\":";
+    message.prefix += response.id.empty() ? "null" : response.id;
+    message.prefix += ",\"result\":";
+    
+    // Notification handlers return "", which is not a valid result value
+    message.body = response.result.empty() ? std::string("null") : std::move(response.result);
+    message.suffix = "}";
+    return message;
 }
 
-std::string LSPServer::extractParam(const std::map<std::string, std::string>& params, const std::string& key) const {
-    auto it = params.find(key);
-    return (it != params.end()) ? it->second : "";
+OutgoingMessage LSPServer::formatError(const std::string& id, int code, const std::string& message) const {
+    std::string json;
+    json.reserve(64 + message.size());
+    json += "{\"jsonrpc\":\"2.0\",\"id\":";
+    json += id.empty() ? "null" : id;
+    json += ",\"error\":{\"code\":";
+    json += std::to_string(code);
+    json += ",\"message\":\"";
+    JsonExporter::appendEscaped(json, message);
+    json += "\"}}";
+    return OutgoingMessage(std::move(json));
 }
 
 void LSPServer::logMessage(const std::string& message) const {
     if (m_loggingEnabled) {
-        std::cerr << "[LSP] " << message << std::endl;
+        // One write per line so messages from worker threads do not interleave
+        std::cerr << ("[LSP] " + message + "\n") << std::flush;
     }
 }
 
@@ -317,6 +855,31 @@ std::string LSPServer::uriToPath(const std::string& uri) const {
     return uri;
 }
 
+std::string LSPServer::identifierAt(const std::string& filePath, const LSPPosition& position, int& startCharacter) {
+    std::string line;
+    bool open = false;
+    {
+        std::lock_guard<std::mutex> lock(m_documentsMutex);
+        if (const TextDocument* document = m_documents.find(filePath)) {
+            line = document->getLine(position.line);
+            open = true;
+        }
+    }
+    
+    if (!open) {
+        std::ifstream file(filePath);
+        for (int i = 0; i <= position.line && std::getline(file, line); i++) {
+        }
+        if (!file) {
+            return "";
+        }
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return IdentifierIndex::identifierAt(line, position.character, startCharacter);
+}
+
 std::string LSPServer::pathToUri(const std::string& path) const {
     return "file://" + path;
 }
@@ -330,11 +893,12 @@ void LSPServer::initializeHandlers() {
     m_handlers["textDocument/didOpen"] = [this](const auto& params) { return handleTextDocumentDidOpen(params); };
     m_handlers["textDocument/didChange"] = [this](const auto& params) { return handleTextDocumentDidChange(params); };
     m_handlers["textDocument/didClose"] = [this](const auto& params) { return handleTextDocumentDidClose(params); };
-    m_handlers["textDocument/documentSymbol"] = [this](const auto& params) { return handleTextDocumentDocumentSymbol(params); };
-    m_handlers["textDocument/definition"] = [this](const auto& params) { return handleTextDocumentDefinition(params); };
-    m_handlers["textDocument/references"] = [this](const auto& params) { return handleTextDocumentReferences(params); };
-    m_handlers["textDocument/hover"] = [this](const auto& params) { return handleTextDocumentHover(params); };
-    
-    m_handlers["workspace/symbol"] = [this](const auto& params) { return handleWorkspaceSymbol(params); };
     m_handlers["workspace/didChangeWatchedFiles"] = [this](const auto& params) { return handleWorkspaceDidChangeWatchedFiles(params); };
+    m_handlers["$/cancelRequest"] = [this](const auto& params) { return handleCancelRequest(params); };
+    
+    m_queryHandlers["textDocument/documentSymbol"] = [this](const auto& params, const auto& cancel) { return handleTextDocumentDocumentSymbol(params, cancel); };
+    m_queryHandlers["textDocument/definition"] = [this](const auto& params, const auto& cancel) { return handleTextDocumentDefinition(params, cancel); };
+    m_queryHandlers["textDocument/references"] = [this](const auto& params, const auto& cancel) { return handleTextDocumentReferences(params, cancel); };
+    m_queryHandlers["textDocument/hover"] = [this](const auto& params, const auto& cancel) { return handleTextDocumentHover(params, cancel); };
+    m_queryHandlers["workspace/symbol"] = [this](const auto& params, const auto& cancel) { return handleWorkspaceSymbol(params, cancel); };
 } 
\ No newline at end of file
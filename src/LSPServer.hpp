@@ -1,19 +1,62 @@
 #pragma once
 
 #include "Symbol.hpp"
+#include "WorkspaceIndex.hpp"
+#include "IndexHost.hpp"
 #include "JsonExporter.hpp"
+#include "JsonReader.hpp"
+#include "LSPTransport.hpp"
+#include "DocumentStore.hpp"
+#include "ThreadPool.hpp"
+#include "CancellationToken.hpp"
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+struct LSPPosition {
+    int line = 0;
+    int character = 0;
+};
+
+// Typed accessors over a request's "params" object. Reads go straight to the
+// parsed JSON; nothing is extracted up front that the handler does not ask for.
+class LSPParams {
+public:
+    LSPParams() = default;
+    explicit LSPParams(JsonView params) : m_params(params) {}
+    
+    JsonView json() const { return m_params; }
+    
+    std::string uri() const;            // textDocument.uri
+    int64_t version() const;            // textDocument.version
+    std::string text() const;           // textDocument.text (didOpen)
+    LSPPosition position() const;
+    std::string query() const;          // workspace/symbol
+    bool includeDeclaration() const;    // references context; defaults to true
+    std::string rootUri() const;        // rootUri, or rootPath from older clients
+    JsonView contentChanges() const;    // didChange
+    JsonView changes() const;           // didChangeWatchedFiles
+    
+private:
+    JsonView m_params;
+};
 
 struct LSPRequest {
     std::string jsonrpc;
     std::string method;
-    std::string id;
-    std::map<std::string, std::string> params;
+    std::string id;  // raw JSON of the id (number or string); empty for notifications
+    std::shared_ptr<JsonDocument> document;  // owns the text params point into
+    LSPParams params;
     
     LSPRequest() : jsonrpc("2.0") {}
+    bool isNotification() const { return id.empty(); }
 };
 
 struct LSPResponse {
@@ -21,75 +64,159 @@ struct LSPResponse {
     std::string id;
     std::string result;
     std::string error;
+    int errorCode;
     
-    LSPResponse() : jsonrpc("2.0") {}
+    LSPResponse() : jsonrpc("2.0"), errorCode(0) {}
 };
 
+// Messages are read on the calling thread of start(). Notifications and
+// requests that change state run there, in arrival order. Read-only queries
+// go to a worker pool and run against an immutable index snapshot, so a slow
+// workspace/symbol never holds up the didChange behind it. All output goes
+// through one writer thread.
 class LSPServer {
 public:
-    LSPServer();
-    ~LSPServer() = default;
+    LSPServer();  // stdio, with an index of its own
+    
+    // One client of a daemon: speaks LSP over the given descriptors and
+    // shares the daemon's index and query pool with every other client
+    LSPServer(std::shared_ptr<IndexHost> host, int inputFd, int outputFd, ThreadPool& queryPool);
+    ~LSPServer();
+    
+    // Query threads for one stdio server, or for all of a daemon's clients
+    static size_t defaultQueryThreadCount();
     
     // Core LSP lifecycle
     void start();
     void stop();
     bool isRunning() const { return m_running; }
     
-    // Message handling
-    std::string processMessage(const std::string& message);
+    // Synchronous message handling: takes one JSON-RPC body, returns the
+    // response body (empty for notifications)
+    std::string processMessage(std::string message);
     LSPResponse processRequest(const LSPRequest& request);
     
     // LSP method handlers
-    std::string handleInitialize(const std::map<std::string, std::string>& params);
-    std::string handleInitialized(const std::map<std::string, std::string>& params);
-    std::string handleShutdown(const std::map<std::string, std::string>& params);
-    std::string handleExit(const std::map<std::string, std::string>& params);
+    std::string handleInitialize(const LSPParams& params);
+    std::string handleInitialized(const LSPParams& params);
+    std::string handleShutdown(const LSPParams& params);
+    std::string handleExit(const LSPParams& params);
     
     // Document methods
-    std::string handleTextDocumentDidOpen(const std::map<std::string, std::string>& params);
-    std::string handleTextDocumentDidChange(const std::map<std::string, std::string>& params);
-    std::string handleTextDocumentDidClose(const std::map<std::string, std::string>& params);
-    std::string handleTextDocumentDocumentSymbol(const std::map<std::string, std::string>& params);
+    std::string handleTextDocumentDidOpen(const LSPParams& params);
+    std::string handleTextDocumentDidChange(const LSPParams& params);
+    std::string handleTextDocumentDidClose(const LSPParams& params);
+    std::string handleTextDocumentDocumentSymbol(const LSPParams& params, const CancellationToken& cancel);
     
     // Workspace methods
-    std::string handleWorkspaceSymbol(const std::map<std::string, std::string>& params);
-    std::string handleWorkspaceDidChangeWatchedFiles(const std::map<std::string, std::string>& params);
+    std::string handleWorkspaceSymbol(const LSPParams& params, const CancellationToken& cancel);
+    std::string handleWorkspaceDidChangeWatchedFiles(const LSPParams& params);
     
     // Symbol navigation
-    std::string handleTextDocumentDefinition(const std::map<std::string, std::string>& params);
-    std::string handleTextDocumentReferences(const std::map<std::string, std::string>& params);
-    std::string handleTextDocumentHover(const std::map<std::string, std::string>& params);
+    std::string handleTextDocumentDefinition(const LSPParams& params, const CancellationToken& cancel);
+    std::string handleTextDocumentReferences(const LSPParams& params, const CancellationToken& cancel);
+    std::string handleTextDocumentHover(const LSPParams& params, const CancellationToken& cancel);
+    
+    // $/cancelRequest
+    std::string handleCancelRequest(const LSPParams& params);
     
     // Configuration
     void setWorkspaceRoot(const std::string& root);
     void enableLogging(bool enable) { m_loggingEnabled = enable; }
     
-    // Index management
+    // Index management, forwarded to the IndexHost
+    void startIndexing();
+    void stopIndexing();
     void rebuildIndex();
-    void updateFile(const std::string& filePath);
+    void updateFile(const std::string& filePath);                           // re-read from disk
+    void updateDocument(const std::string& filePath, const std::string& text); // unsaved buffer
+    void removeFile(const std::string& filePath);
+
+    // Current index snapshot; stays valid for as long as the caller holds it
+    std::shared_ptr<const WorkspaceIndex> acquireIndex() const;
 
 private:
+    using Handler = std::function<std::string(const LSPParams&)>;
+    using QueryHandler = std::function<std::string(const LSPParams&, const CancellationToken&)>;
+    
+    // Most workspace/symbol results a single response carries
+    static constexpr size_t WORKSPACE_SYMBOL_LIMIT = 100;
+    static constexpr size_t REFERENCES_LIMIT = 5000;
+    static constexpr size_t HOVER_DEFINITION_LIMIT = 3;
+    
+    // Asynchronous dispatch
+    void dispatchMessage(std::string message);
+    void runQuery(const std::shared_ptr<LSPRequest>& request, const QueryHandler& handler, uint64_t generation,
+                  const std::shared_ptr<CancellationToken>& token);
+    void finishQuery(const std::string& id);
+    void waitForQueries();
+    void sendMessage(OutgoingMessage message);
+    void writerLoop();
+    void stopWriter();
+    
+    // $/progress for scans of the index this server owns
+    void reportProgress(const std::string& kind, const std::string& message, int percentage);
+    void handleProgressCreated(const LSPRequest& reply);
+    
+    // Hand a departing daemon client's buffers back to the disk
+    void closeAllDocuments();
+    
     // Message parsing
-    LSPRequest parseRequest(const std::string& message) const;
-    std::string formatResponse(const LSPResponse& response) const;
-    std::string formatError(const std::string& id, int code, const std::string& message) const;
+    bool parseRequest(std::string message, LSPRequest& request, std::string& error) const;
+    OutgoingMessage formatResponse(LSPResponse response) const;   // moves the result, never copies it
+    OutgoingMessage formatError(const std::string& id, int code, const std::string& message) const;
     
     // Utility methods
-    std::string extractParam(const std::map<std::string, std::string>& params, const std::string& key) const;
     void logMessage(const std::string& message) const;
     std::string uriToPath(const std::string& uri) const;
     std::string pathToUri(const std::string& path) const;
     
+    // Identifier under an LSP position, read from the open buffer or the disk
+    std::string identifierAt(const std::string& filePath, const LSPPosition& position, int& startCharacter);
+    
     // Member variables
-    bool m_running = false;
+    std::atomic<bool> m_running;
     bool m_initialized = false;
     bool m_loggingEnabled = false;
-    std::string m_workspaceRoot;
-    std::unique_ptr<SymbolIndex> m_index;
     std::unique_ptr<JsonExporter> m_exporter;
+    LSPTransport m_transport;
+    DocumentStore m_documents;
+    std::mutex m_documentsMutex;  // edited on the reader thread, read by queries
+    
+    // Queries read snapshots published by the host; the reader thread publishes
+    // edits and queries wait for the last one it queued before they run
+    std::shared_ptr<IndexHost> m_host;
+    bool m_sharedHost;
+    uint64_t m_lastPublish = 0;  // reader thread only
+    
+    // Progress. Reports for a token are held back until the client answers
+    // window/workDoneProgress/create for it, and dropped if it refuses
+    enum class ProgressState { CREATING, READY, REFUSED };
+    bool m_workDoneProgress = false;  // client accepts window/workDoneProgress/create
+    int m_progressCount = 0;
+    std::string m_progressToken;
+    ProgressState m_progressState = ProgressState::REFUSED;
+    std::vector<std::string> m_heldProgress;
+    std::mutex m_progressMutex;  // reports come from the indexer thread
+    
+    // In-flight queries by raw request id
+    std::unordered_map<std::string, std::shared_ptr<CancellationToken>> m_queries;
+    std::mutex m_queriesMutex;
+    std::condition_variable m_queriesDone;
+    std::unique_ptr<ThreadPool> m_ownQueryPool;  // stdio only
+    ThreadPool& m_queryPool;
+    
+    // Writer thread
+    std::thread m_writer;
+    std::deque<OutgoingMessage> m_outbox;
+    std::mutex m_outboxMutex;
+    std::condition_variable m_outboxCondition;
+    bool m_writerStopping = false;
     
-    // Method handlers map
-    std::map<std::string, std::function<std::string(const std::map<std::string, std::string>&)>> m_handlers;
+    // Method handlers: m_handlers run in order on the reader thread,
+    // m_queryHandlers are read-only and may run concurrently
+    std::map<std::string, Handler> m_handlers;
+    std::map<std::string, QueryHandler> m_queryHandlers;
     
     // Initialize handlers
     void initializeHandlers();
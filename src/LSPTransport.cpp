@@ -0,0 +1,296 @@
+#include "LSPTransport.hpp"
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+LSPTransport::LSPTransport(int inputFd, int outputFd)
+    : m_inputFd(inputFd)
+    , m_outputFd(outputFd)
+    , m_buffer(INITIAL_BUFFER_SIZE)
+    , m_begin(0)
+    , m_end(0)
+    , m_skip(0)
+{
+}
+
+bool LSPTransport::readMessage(std::string& body) {
+    if (m_skip > 0 && !skipBody()) {
+        return false;
+    }
+
+    while (true) {
+        // Skip blank lines between messages
+        while (m_begin < m_end && (m_buffer[m_begin] == '\r' || m_buffer[m_begin] == '\n' ||
+                                   m_buffer[m_begin] == ' ' || m_buffer[m_begin] == '\t')) {
+            m_begin++;
+        }
+
+        if (m_begin == m_end) {
+            if (!fill()) {
+                return false;
+            }
+            continue;
+        }
+
+        // Unframed fallback: one JSON object per line
+        if (m_buffer[m_begin] == '{') {
+            const char* start = m_buffer.data() + m_begin;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', m_end - m_begin));
+            if (!newline) {
+                if (!fill()) {
+                    body.assign(start, m_end - m_begin);
+                    m_begin = m_end;
+                    return !body.empty();
+                }
+                continue;
+            }
+
+            body.assign(start, newline - start);
+            m_begin += (newline - start) + 1;
+            return true;
+        }
+
+        size_t headerEnd = findHeaderEnd();
+        if (headerEnd == 0) {
+            if (m_end - m_begin > MAX_HEADER_SIZE) {
+                // Not a header block; drop it rather than buffering forever
+                m_begin = m_end;
+                continue;
+            }
+            if (!fill()) {
+                return false;
+            }
+            continue;
+        }
+
+        size_t contentLength = 0;
+        bool framed = parseContentLength(m_buffer.data() + m_begin, headerEnd - m_begin, contentLength);
+        m_begin = headerEnd;
+        if (!framed) {
+            continue;
+        }
+
+        if (contentLength > MAX_CONTENT_LENGTH) {
+            m_skip = contentLength;
+            body.clear();
+            return true;
+        }
+        return readBody(contentLength, body);
+    }
+}
+
+bool LSPTransport::writeMessage(const std::string& body) {
+    const std::string* parts[] = {&body};
+    return writeParts(parts, 1);
+}
+
+bool LSPTransport::writeMessage(const OutgoingMessage& message) {
+    const std::string* parts[] = {&message.prefix, &message.body, &message.suffix};
+    return writeParts(parts, 3);
+}
+
+bool LSPTransport::writeParts(const std::string* const* parts, size_t count) {
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++) {
+        length += parts[i]->size();
+    }
+    char header[48];
+    int headerLength = std::snprintf(header, sizeof(header), "Content-Length: %zu\r\n\r\n", length);
+
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+#ifdef _WIN32
+    if (!writeAll(m_outputFd, header, static_cast<size_t>(headerLength))) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!writeAll(m_outputFd, parts[i]->data(), parts[i]->size())) {
+            return false;
+        }
+    }
+    return true;
+#else
+    iovec vectors[4];
+    vectors[0].iov_base = header;
+    vectors[0].iov_len = static_cast<size_t>(headerLength);
+    for (size_t i = 0; i < count; i++) {
+        vectors[i + 1].iov_base = const_cast<char*>(parts[i]->data());
+        vectors[i + 1].iov_len = parts[i]->size();
+    }
+
+    iovec* next = vectors;
+    int remaining = static_cast<int>(count) + 1;
+    while (remaining > 0) {
+        ssize_t written = writev(m_outputFd, next, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        // A short write resumes partway through a piece
+        size_t skip = static_cast<size_t>(written);
+        while (remaining > 0 && skip >= next->iov_len) {
+            skip -= next->iov_len;
+            next++;
+            remaining--;
+        }
+        if (remaining > 0) {
+            next->iov_base = static_cast<char*>(next->iov_base) + skip;
+            next->iov_len -= skip;
+        }
+    }
+    return true;
+#endif
+}
+
+bool LSPTransport::fill() {
+    // Reclaim consumed space before reading more
+    if (m_begin > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+        m_end -= m_begin;
+        m_begin = 0;
+    }
+    if (m_end == m_buffer.size()) {
+        m_buffer.resize(m_buffer.size() * 2);
+    }
+
+    long count = readSome(m_inputFd, m_buffer.data() + m_end, m_buffer.size() - m_end);
+    if (count <= 0) {
+        return false;
+    }
+    m_end += static_cast<size_t>(count);
+    return true;
+}
+
+bool LSPTransport::readBody(size_t length, std::string& body) {
+    size_t buffered = std::min(length, m_end - m_begin);
+    body.resize(length);
+    std::memcpy(&body[0], m_buffer.data() + m_begin, buffered);
+    m_begin += buffered;
+
+    // Large bodies are read straight into the message instead of through the buffer
+    size_t filled = buffered;
+    while (filled < length) {
+        long count = readSome(m_inputFd, &body[filled], length - filled);
+        if (count <= 0) {
+            return false;
+        }
+        filled += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+bool LSPTransport::skipBody() {
+    // Stream the body through the buffer so the framing stays in sync
+    while (m_skip > 0) {
+        if (m_begin == m_end) {
+            m_begin = m_end = 0;
+            if (!fill()) {
+                return false;
+            }
+        }
+        size_t skipped = std::min(m_skip, m_end - m_begin);
+        m_begin += skipped;
+        m_skip -= skipped;
+    }
+    return true;
+}
+
+size_t LSPTransport::findHeaderEnd() const {
+    static const char terminator[] = "\r\n\r\n";
+    auto end = m_buffer.begin() + m_end;
+    auto found = std::search(m_buffer.begin() + m_begin, end, terminator, terminator + 4);
+    if (found == end) {
+        return 0;
+    }
+    return static_cast<size_t>(found - m_buffer.begin()) + 4;
+}
+
+bool LSPTransport::parseContentLength(const char* headers, size_t length, size_t& contentLength) {
+    static const char name[] = "content-length:";
+    const size_t nameLength = sizeof(name) - 1;
+
+    const char* line = headers;
+    const char* end = headers + length;
+    while (line < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        bool matches = static_cast<size_t>(lineEnd - line) > nameLength;
+        for (size_t i = 0; matches && i < nameLength; i++) {
+            char c = line[i];
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+            matches = c == name[i];
+        }
+
+        if (matches) {
+            const char* digit = line + nameLength;
+            while (digit < lineEnd && *digit == ' ') {
+                digit++;
+            }
+            size_t value = 0;
+            bool any = false;
+            while (digit < lineEnd && *digit >= '0' && *digit <= '9') {
+                // Saturate rather than wrap; anything past the cap is rejected anyway
+                if (value <= MAX_CONTENT_LENGTH) {
+                    value = value * 10 + static_cast<size_t>(*digit - '0');
+                }
+                any = true;
+                digit++;
+            }
+            if (any) {
+                contentLength = value;
+                return true;
+            }
+        }
+
+        line = lineEnd + 1;
+    }
+    return false;
+}
+
+long LSPTransport::readSome(int fd, char* data, size_t length) {
+    while (true) {
+#ifdef _WIN32
+        long count = _read(fd, data, static_cast<unsigned int>(std::min<size_t>(length, 1 << 30)));
+#else
+        long count = static_cast<long>(read(fd, data, length));
+#endif
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        return count;
+    }
+}
+
+bool LSPTransport::writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+#ifdef _WIN32
+        long count = _write(fd, data, static_cast<unsigned int>(std::min<size_t>(length, 1 << 30)));
+#else
+        long count = static_cast<long>(write(fd, data, length));
+#endif
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += count;
+        length -= static_cast<size_t>(count);
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#ifndef LSPTRANSPORT_HPP
+#define LSPTRANSPORT_HPP
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+// One outgoing message body held as pieces written back to back. A response
+// envelope wraps its result as prefix + body + suffix, so the result JSON is
+// moved into place instead of being copied into a larger string.
+struct OutgoingMessage {
+    std::string prefix;
+    std::string body;
+    std::string suffix;
+
+    OutgoingMessage() = default;
+    OutgoingMessage(std::string json) : body(std::move(json)) {}
+
+    size_t size() const { return prefix.size() + body.size() + suffix.size(); }
+    std::string str() const { return prefix + body + suffix; }
+};
+
+// Base protocol framing for LSP over a pair of file descriptors:
+//   Content-Length: <n>\r\n
+//   \r\n
+//   <n bytes of JSON>
+// Input is read in large chunks into one reusable buffer, so a message costs
+// a header scan and a single copy of its body. Output goes out as one
+// gathered write of the header and the message pieces, with no staging copy.
+// A line holding a bare JSON object is accepted too, which keeps
+// `echo '{...}' | navix --lsp` usable.
+class LSPTransport {
+public:
+    explicit LSPTransport(int inputFd = 0, int outputFd = 1);
+
+    // Blocks for the next message body; false on end of input. A body over
+    // MAX_CONTENT_LENGTH comes back empty, which the caller rejects as a parse
+    // error, and is discarded unread before the next message
+    bool readMessage(std::string& body);
+
+    // Frame and write one message; safe to call from several threads
+    bool writeMessage(const std::string& body);
+    bool writeMessage(const OutgoingMessage& message);
+
+private:
+    static const size_t INITIAL_BUFFER_SIZE = 64 * 1024;
+    static const size_t MAX_HEADER_SIZE = 8 * 1024;
+    static const size_t MAX_CONTENT_LENGTH = 256 * 1024 * 1024;
+
+    int m_inputFd;
+    int m_outputFd;
+    std::vector<char> m_buffer;
+    size_t m_begin;
+    size_t m_end;
+    size_t m_skip;  // bytes of a rejected body still to discard
+    std::mutex m_writeMutex;
+
+    bool fill();
+    bool readBody(size_t length, std::string& body);
+    bool skipBody();
+    size_t findHeaderEnd() const;
+    static bool parseContentLength(const char* headers, size_t length, size_t& contentLength);
+    bool writeParts(const std::string* const* parts, size_t count);
+
+    static long readSome(int fd, char* data, size_t length);
+    static bool writeAll(int fd, const char* data, size_t length);
+};
+
+#endif // LSPTRANSPORT_HPP
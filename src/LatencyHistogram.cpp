@@ -0,0 +1,118 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+
+LatencyHistogram::LatencyHistogram()
+    : m_counts(SUB_BUCKET_COUNT + MAGNITUDES * SUB_BUCKET_HALF, 0)
+    , m_total(0)
+    , m_min(UINT64_MAX)
+    , m_max(0)
+    , m_sum(0)
+{
+}
+
+void LatencyHistogram::record(std::chrono::microseconds value) {
+    uint64_t micros = value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+    
+    m_counts[indexOf(micros)]++;
+    m_total++;
+    m_sum += micros;
+    m_min = std::min(m_min, micros);
+    m_max = std::max(m_max, micros);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_total += other.m_total;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_total = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+    m_sum = 0;
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return m_total;
+}
+
+uint64_t LatencyHistogram::getCountAtOrBelow(std::chrono::microseconds value) const {
+    if (value.count() < 0) {
+        return 0;
+    }
+    
+    size_t last = indexOf(static_cast<uint64_t>(value.count()));
+    uint64_t count = 0;
+    for (size_t i = 0; i <= last; i++) {
+        count += m_counts[i];
+    }
+    return count;
+}
+
+std::chrono::microseconds LatencyHistogram::getMin() const {
+    return std::chrono::microseconds(m_total ? m_min : 0);
+}
+
+std::chrono::microseconds LatencyHistogram::getMax() const {
+    return std::chrono::microseconds(m_max);
+}
+
+std::chrono::microseconds LatencyHistogram::getMean() const {
+    return std::chrono::microseconds(m_total ? m_sum / m_total : 0);
+}
+
+std::chrono::microseconds LatencyHistogram::getPercentile(double percentile) const {
+    if (m_total == 0) {
+        return std::chrono::microseconds(0);
+    }
+    
+    percentile = std::min(std::max(percentile, 0.0), 1.0);
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(percentile * m_total + 0.5));
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        seen += m_counts[i];
+        if (seen >= target) {
+            // Bucket edges can overshoot the largest value actually recorded
+            return std::chrono::microseconds(std::min(highestEquivalent(i), m_max));
+        }
+    }
+    return std::chrono::microseconds(m_max);
+}
+
+size_t LatencyHistogram::indexOf(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    
+    // Shift the value down until it lands in the upper half of the sub-buckets
+    int highestBit = 63 - __builtin_clzll(value);
+    int shift = highestBit - (SUB_BUCKET_BITS - 1);
+    if (shift > MAGNITUDES) {
+        return SUB_BUCKET_COUNT + MAGNITUDES * SUB_BUCKET_HALF - 1;
+    }
+    
+    uint64_t subBucket = value >> shift;
+    return static_cast<size_t>(SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + (subBucket - SUB_BUCKET_HALF));
+}
+
+uint64_t LatencyHistogram::highestEquivalent(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    if (index == SUB_BUCKET_COUNT + MAGNITUDES * SUB_BUCKET_HALF - 1) {
+        // The last bucket also holds everything indexOf clamped into it
+        return UINT64_MAX;
+    }
+    
+    size_t offset = index - SUB_BUCKET_COUNT;
+    int shift = static_cast<int>(offset / SUB_BUCKET_HALF) + 1;
+    uint64_t subBucket = offset % SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+    return ((subBucket + 1) << shift) - 1;
+}
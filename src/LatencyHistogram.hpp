@@ -0,0 +1,47 @@
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// Fixed-size latency histogram in the style of HdrHistogram: each power-of-two
+// range of microseconds is split into 32 equal sub-buckets, so a reported value
+// is at most ~3% above the recorded one from 1us up to about three days, while
+// the memory stays constant. Not synchronized; owners guard it with their own lock.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(std::chrono::microseconds value);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t getCount() const;
+    uint64_t getCountAtOrBelow(std::chrono::microseconds value) const;
+    std::chrono::microseconds getMin() const;
+    std::chrono::microseconds getMax() const;
+    std::chrono::microseconds getMean() const;
+
+    // percentile in [0, 1]; reports the upper edge of the bucket it falls in
+    std::chrono::microseconds getPercentile(double percentile) const;
+
+private:
+    // Values below 2^SUB_BUCKET_BITS are exact; each power of two above them
+    // gets SUB_BUCKET_HALF sub-buckets
+    static const int SUB_BUCKET_BITS = 6;
+    static const uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const uint64_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static const int MAGNITUDES = 32;
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_total;
+    uint64_t m_min;
+    uint64_t m_max;
+    uint64_t m_sum;
+
+    static size_t indexOf(uint64_t value);
+    static uint64_t highestEquivalent(size_t index);
+};
+
+#endif // LATENCYHISTOGRAM_HPP
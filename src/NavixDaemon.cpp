@@ -0,0 +1,286 @@
+#include "NavixDaemon.hpp"
+#include "DaemonClient.hpp"
+#include "LSPServer.hpp"
+#include "FileScanner.hpp"
+#include "WatchJournal.hpp"
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Longest query line accepted before the connection is dropped
+const size_t MAX_QUERY_LENGTH = 4096;
+
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+void requestStop(int) {
+    g_stopRequested = 1;
+}
+
+// Fields are tab separated; tabs and line breaks inside them become spaces
+void appendField(std::string& out, const std::string& value) {
+    for (char c : value) {
+        out += (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+    }
+}
+
+#ifndef _WIN32
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+NavixDaemon::NavixDaemon(const std::string& rootPath)
+    : m_listenFd(-1)
+    , m_running(false)
+    , m_queryPool(LSPServer::defaultQueryThreadCount())
+{
+    // Clients run from anywhere, so every path handed out must be absolute
+    std::error_code ec;
+    m_rootPath = std::filesystem::weakly_canonical(std::filesystem::absolute(rootPath, ec), ec).string();
+    if (ec || m_rootPath.empty()) {
+        m_rootPath = rootPath;
+    }
+    m_socketPath = socketPath(m_rootPath);
+
+    m_host = std::make_shared<IndexHost>(m_rootPath);
+    m_host->setLogCallback([](const std::string& message) {
+        std::cerr << "[daemon] " + message + "\n";
+    });
+}
+
+NavixDaemon::~NavixDaemon() {
+    stop();
+}
+
+std::string NavixDaemon::socketPath(const std::string& rootPath) {
+    return WatchJournal::defaultDirectory(rootPath) + "/daemon.sock";
+}
+
+#ifdef _WIN32
+
+bool NavixDaemon::start() {
+    std::cerr << "❌ Daemon mode needs Unix domain sockets, which this platform lacks\n";
+    return false;
+}
+
+void NavixDaemon::run() {
+}
+
+void NavixDaemon::stop() {
+}
+
+void NavixDaemon::serveClient(int fd) {
+}
+
+void NavixDaemon::serveQuery(int fd) {
+}
+
+#else
+
+bool NavixDaemon::start() {
+    if (DaemonClient::isRunning(m_rootPath)) {
+        std::cerr << "❌ A daemon is already serving " << m_rootPath << " on " << m_socketPath << "\n";
+        return false;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (m_socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "❌ Socket path is too long: " << m_socketPath << "\n";
+        return false;
+    }
+    std::memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size() + 1);
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(m_socketPath).parent_path(), ec);
+
+    // Nobody answered, so any socket file left behind belongs to a dead daemon
+    ::unlink(m_socketPath.c_str());
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0 ||
+        ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(m_listenFd, 64) < 0) {
+        std::cerr << "❌ Cannot listen on " << m_socketPath << ": " << std::strerror(errno) << "\n";
+        if (m_listenFd >= 0) {
+            ::close(m_listenFd);
+            m_listenFd = -1;
+        }
+        return false;
+    }
+
+    // A client hanging up mid-response must not take the daemon down with it
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    m_running = true;
+
+    m_host->startIndexing();
+
+    m_watcher.setDebounceTime(std::chrono::milliseconds(25));
+    m_watcher.setBatchCallback([this](const std::vector<FileChange>& batch) { applyChanges(batch); });
+    if (!m_watcher.startWatching(m_rootPath, FileScanner::getSupportedExtensions())) {
+        std::cerr << "⚠️  File watcher failed to start; the index will not follow edits on disk\n";
+    }
+    return true;
+}
+
+void NavixDaemon::run() {
+    while (m_running && !g_stopRequested) {
+        // Wake up now and then to notice a stop request
+        pollfd listener{m_listenFd, POLLIN, 0};
+        if (::poll(&listener, 1, 250) <= 0) {
+            continue;
+        }
+
+        int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_clientsMutex);
+            m_clients.insert(fd);
+        }
+        std::thread([this, fd]() {
+            serveClient(fd);
+
+            std::lock_guard<std::mutex> lock(m_clientsMutex);
+            m_clients.erase(fd);
+            ::close(fd);
+            m_clientsDone.notify_all();
+        }).detach();
+    }
+    stop();
+}
+
+void NavixDaemon::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    m_watcher.stopWatching();
+    ::close(m_listenFd);
+    m_listenFd = -1;
+    ::unlink(m_socketPath.c_str());
+
+    // Stopping the scan first releases queries waiting for it; then hang up
+    // on every client and wait for its session to wind down
+    m_host->stopIndexing();
+    std::unique_lock<std::mutex> lock(m_clientsMutex);
+    for (int fd : m_clients) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    m_clientsDone.wait(lock, [this]() { return m_clients.empty(); });
+}
+
+void NavixDaemon::serveClient(int fd) {
+    char first = 0;
+    ssize_t n;
+    do {
+        n = ::recv(fd, &first, 1, MSG_PEEK);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        return;
+    }
+
+    if (first == 'C' || first == '{') {
+        LSPServer session(m_host, fd, fd, m_queryPool);
+        session.enableLogging(true);
+        session.start();
+    } else {
+        serveQuery(fd);
+    }
+}
+
+void NavixDaemon::serveQuery(int fd) {
+    std::string line;
+    char buffer[1024];
+    while (line.find('\n') == std::string::npos && line.size() < MAX_QUERY_LENGTH) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        line.append(buffer, static_cast<size_t>(n));
+    }
+    line = line.substr(0, line.find('\n'));
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+
+    size_t space = line.find(' ');
+    std::string command = line.substr(0, space);
+    std::string argument = space == std::string::npos ? "" : line.substr(space + 1);
+
+    if (command != "search" && command != "search-exact") {
+        sendAll(fd, "error unknown command: " + command + "\n");
+        return;
+    }
+
+    // Same answers as a fresh process would give, so wait out the first scan
+    m_host->waitForIndex();
+    auto index = m_host->acquire();
+
+    std::string response;
+    for (const Symbol& symbol : index->getSymbols().search(argument, command == "search")) {
+        response += std::to_string(static_cast<int>(symbol.type));
+        response += '\t';
+        response += std::to_string(symbol.line);
+        response += '\t';
+        appendField(response, symbol.file);
+        response += '\t';
+        appendField(response, symbol.name);
+        response += '\t';
+        appendField(response, symbol.context);
+        response += '\n';
+    }
+    sendAll(fd, response);
+}
+
+#endif
+
+void NavixDaemon::applyChanges(const std::vector<FileChange>& batch) {
+    // Parsing happens on the host's publisher, so this thread goes straight
+    // back to draining events. Disk changes never replace a buffer some
+    // client has open
+    std::vector<std::string> changed;
+    std::vector<std::string> removed;
+    for (const auto& change : batch) {
+        switch (change.event) {
+            case FileEvent::DELETED:
+                removed.push_back(change.path);
+                break;
+            case FileEvent::MOVED:
+                removed.push_back(change.oldPath);
+                changed.push_back(change.path);
+                break;
+            case FileEvent::CREATED:
+            case FileEvent::MODIFIED:
+                changed.push_back(change.path);
+                break;
+        }
+    }
+    m_host->publishFromDisk(std::move(changed), std::move(removed));
+}
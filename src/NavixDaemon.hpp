@@ -0,0 +1,62 @@
+#ifndef NAVIXDAEMON_HPP
+#define NAVIXDAEMON_HPP
+
+#include "IndexHost.hpp"
+#include "FileWatcher.hpp"
+#include "ThreadPool.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// `navix <root> --daemon`: one long-lived process per workspace root that
+// holds the index and the file watcher, and serves any number of clients
+// over a Unix domain socket in the root's cache directory.
+//
+// A connection that opens like an LSP message (a Content-Length header or a
+// bare JSON object) is an editor session. Anything else is a single query
+// line, answered with one symbol per line before the daemon hangs up:
+//   search <query>          fuzzy, as --search
+//   search-exact <name>     as --search-exact
+//   <type>\t<line>\t<file>\t<name>\t<context>
+class NavixDaemon {
+public:
+    explicit NavixDaemon(const std::string& rootPath);
+    ~NavixDaemon();
+
+    NavixDaemon(const NavixDaemon&) = delete;
+    NavixDaemon& operator=(const NavixDaemon&) = delete;
+
+    // Bind the socket and start indexing and watching; false if another
+    // daemon already serves the root or the socket cannot be created
+    bool start();
+
+    // Accept clients until stop(), SIGINT or SIGTERM
+    void run();
+    void stop();
+
+    static std::string socketPath(const std::string& rootPath);
+
+private:
+    std::string m_rootPath;
+    std::string m_socketPath;
+    int m_listenFd;
+    std::atomic<bool> m_running;
+    std::shared_ptr<IndexHost> m_host;
+    FileWatcher m_watcher;
+    ThreadPool m_queryPool;  // shared by every editor session
+
+    // Connected clients, so stop() can hang up on them and wait
+    std::set<int> m_clients;
+    std::mutex m_clientsMutex;
+    std::condition_variable m_clientsDone;
+
+    void serveClient(int fd);
+    void serveQuery(int fd);
+    void applyChanges(const std::vector<FileChange>& batch);
+};
+
+#endif // NAVIXDAEMON_HPP
@@ -1,4 +1,5 @@
 #include "PerformanceLogger.hpp"
+#include "FileWatcher.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -11,6 +12,10 @@ PerformanceLogger::PerformanceLogger()
     , m_logFilename("navix_performance.log")
     , m_minLogTime(std::chrono::milliseconds(1))
     , m_sessionActive(false)
+    , m_lastReindexLatency(0)
+    , m_reindexFiles(0)
+    , m_lastEventsRead(0)
+    , m_lastEventsDelivered(0)
     , m_filesProcessed(0)
     , m_symbolsFound(0)
     , m_errorsEncountered(0)
@@ -140,6 +145,82 @@ void PerformanceLogger::logError(const std::string& filePath, const std::string&
     }
 }
 
+void PerformanceLogger::logReindex(size_t fileCount, std::chrono::microseconds parseTime, 
+                                   std::chrono::microseconds latency) {
+    {
+        std::lock_guard<std::mutex> lock(m_metricsMutex);
+        m_reindexLatency.record(latency);
+        m_lastReindexLatency = latency;
+        m_reindexFiles += fileCount;
+    }
+    
+    if (m_verbose) {
+        std::cout << "🔁 Re-indexed " << fileCount << " files: parse " 
+                  << std::fixed << std::setprecision(1) << parseTime.count() / 1000.0 << "ms, save → searchable "
+                  << latency.count() / 1000.0 << "ms\n";
+    }
+    
+    if (m_logToFile) {
+        std::ostringstream oss;
+        oss << getCurrentTimeString() << " - reindex | " << fileCount << " files"
+            << " | parse " << parseTime.count() << "us | latency " << latency.count() << "us";
+        writeToLog(oss.str());
+    }
+}
+
+void PerformanceLogger::printReindexSummary() const {
+    std::lock_guard<std::mutex> lock(m_metricsMutex);
+    
+    if (m_reindexLatency.getCount() == 0) {
+        return;
+    }
+    
+    auto percentile = [this](double p) {
+        return m_reindexLatency.getPercentile(p).count() / 1000.0;
+    };
+    
+    std::cout << "\n┌─ LIVE RE-INDEX ────────────────────────────────────────────────────────────┐\n";
+    std::cout << "│ 🔁 Batches: " << m_reindexLatency.getCount() << ", Files: " << m_reindexFiles << "\n";
+    std::cout << "│ ⏱️  Save → searchable: p50 " << std::fixed << std::setprecision(1) << percentile(0.5) 
+              << "ms, p95 " << percentile(0.95) << "ms, max " << percentile(1.0) << "ms\n";
+    std::cout << "│ 🎯 Within 50ms: " << m_reindexLatency.getCountAtOrBelow(std::chrono::milliseconds(50)) 
+              << "/" << m_reindexLatency.getCount() << "\n";
+    std::cout << "└────────────────────────────────────────────────────────────────────────────┘\n\n";
+}
+
+void PerformanceLogger::logWatcherStats(const WatcherStats& stats) {
+    std::chrono::microseconds reindexLag;
+    size_t readDelta;
+    size_t deliveredDelta;
+    {
+        std::lock_guard<std::mutex> lock(m_metricsMutex);
+        reindexLag = m_lastReindexLatency;
+        readDelta = stats.eventsRead - std::min(m_lastEventsRead, stats.eventsRead);
+        deliveredDelta = stats.eventsDelivered - std::min(m_lastEventsDelivered, stats.eventsDelivered);
+        m_lastEventsRead = stats.eventsRead;
+        m_lastEventsDelivered = stats.eventsDelivered;
+    }
+    
+    auto ms = [](std::chrono::microseconds value) { return value.count() / 1000.0; };
+    const LatencyHistogram& latency = stats.deliveryLatency;
+    
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << "watches " << stats.watches << " | files " << stats.watchedFiles
+        << " | read " << stats.eventsRead << " (+" << readDelta << ")"
+        << " | delivered " << stats.eventsDelivered << " (+" << deliveredDelta << ")"
+        << " | coalesced " << stats.eventsCoalesced << " | dropped " << stats.eventsDropped
+        << " | overflows " << stats.overflows
+        << " | latency p50 " << ms(latency.getPercentile(0.5)) << "ms p99 " << ms(latency.getPercentile(0.99))
+        << "ms max " << ms(latency.getMax()) << "ms | reindex lag " << ms(reindexLag) << "ms";
+    
+    std::cout << "📊 Watcher: " << oss.str() << "\n";
+    
+    if (m_logToFile) {
+        writeToLog(getCurrentTimeString() + " - watcher | " + oss.str());
+    }
+}
+
 SessionMetrics PerformanceLogger::getCurrentSession() const {
     std::lock_guard<std::mutex> lock(m_metricsMutex);
     return m_currentSession;
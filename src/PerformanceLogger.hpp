@@ -8,6 +8,9 @@
 #include <fstream>
 #include <mutex>
 #include <atomic>
+#include "LatencyHistogram.hpp"
+
+struct WatcherStats;
 
 struct FileMetrics {
     std::string filePath;
@@ -55,6 +58,15 @@ public:
     void logSymbol(const std::string& symbolType);
     void logError(const std::string& filePath, const std::string& error);
     
+    // Live re-index logging: latency runs from the first file event of a batch
+    // until the rebuilt index generation is published
+    void logReindex(size_t fileCount, std::chrono::microseconds parseTime, std::chrono::microseconds latency);
+    void printReindexSummary() const;
+    
+    // Periodic watcher health line: counter deltas since the previous call,
+    // delivery latency percentiles and the current re-index lag
+    void logWatcherStats(const WatcherStats& stats);
+    
     // Statistics
     SessionMetrics getCurrentSession() const;
     std::vector<FileMetrics> getFileMetrics() const;
@@ -87,6 +99,15 @@ private:
     std::map<std::string, std::chrono::steady_clock::time_point> m_fileStartTimes;
     std::vector<FileMetrics> m_fileMetrics;
     
+    // Re-index tracking
+    LatencyHistogram m_reindexLatency;
+    std::chrono::microseconds m_lastReindexLatency;
+    size_t m_reindexFiles;
+    
+    // Watcher counters at the previous logWatcherStats call
+    size_t m_lastEventsRead;
+    size_t m_lastEventsDelivered;
+    
     // Thread safety
     mutable std::mutex m_metricsMutex;
     std::mutex m_fileMutex;
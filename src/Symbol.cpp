@@ -8,7 +8,7 @@
 #include <cctype>
 #include <set> // Added for SymbolIndex::loadSymbols workaround
 
-SymbolIndex::SymbolIndex() : m_logger(nullptr) {
+SymbolIndex::SymbolIndex() : m_symbolCount(0), m_logger(nullptr) {
 }
 
 void SymbolIndex::setPerformanceLogger(PerformanceLogger* logger) {
@@ -16,7 +16,11 @@ void SymbolIndex::setPerformanceLogger(PerformanceLogger* logger) {
 }
 
 void SymbolIndex::addSymbol(const Symbol& symbol) {
-    symbols.push_back(symbol);
+    FileId file = fileIdFor(symbol.file);
+    std::vector<Symbol>& fileSymbols = m_fileSymbols[file];
+    fileSymbols.push_back(symbol);
+    m_symbolCount++;
+    indexName(symbol, file, static_cast<uint32_t>(fileSymbols.size() - 1));
     
     if (m_logger) {
         m_logger->logSymbol(symbolTypeToString(symbol.type));
@@ -31,6 +35,91 @@ void SymbolIndex::buildIndex(const std::vector<std::string>& files) {
     }
 }
 
+void SymbolIndex::indexFile(const std::string& filePath) {
+    parseFile(filePath);
+}
+
+void SymbolIndex::indexText(const std::string& filePath, const std::string& text) {
+    std::istringstream input(text);
+    parseStream(input, filePath);
+}
+
+size_t SymbolIndex::removeFile(const std::string& filePath) {
+    FileId id;
+    if (!findFileId(filePath, id) || m_fileSymbols[id].empty()) {
+        return 0;
+    }
+    
+    std::vector<Symbol> removed;
+    removed.swap(m_fileSymbols[id]);
+    m_symbolCount -= removed.size();
+    
+    for (const Symbol& symbol : removed) {
+        auto refs = m_nameIndex.find(symbol.name);
+        if (refs == m_nameIndex.end()) {
+            continue;
+        }
+        auto& list = refs->second;
+        list.erase(std::remove_if(list.begin(), list.end(), [id](const NameRef& ref) { return ref.file == id; }),
+                   list.end());
+        if (list.empty()) {
+            m_nameIndex.erase(refs);
+        }
+    }
+    return removed.size();
+}
+
+void SymbolIndex::updateFile(const std::string& filePath, const std::vector<Symbol>& fileSymbols) {
+    removeFile(filePath);
+    
+    FileId file = fileIdFor(filePath);
+    m_fileSymbols[file] = fileSymbols;
+    m_symbolCount += fileSymbols.size();
+    
+    for (size_t i = 0; i < fileSymbols.size(); i++) {
+        indexName(fileSymbols[i], file, static_cast<uint32_t>(i));
+    }
+}
+
+SymbolSlice SymbolIndex::getFileSymbols(const std::string& filePath) const {
+    FileId id;
+    if (!findFileId(filePath, id)) {
+        return SymbolSlice();
+    }
+    return getFileSymbols(id);
+}
+
+SymbolSlice SymbolIndex::getFileSymbols(FileId id) const {
+    SymbolSlice slice;
+    if (id < m_fileSymbols.size() && !m_fileSymbols[id].empty()) {
+        slice.first = m_fileSymbols[id].data();
+        slice.count = m_fileSymbols[id].size();
+    }
+    return slice;
+}
+
+bool SymbolIndex::findFileId(const std::string& filePath, FileId& id) const {
+    auto it = m_fileIds.find(filePath);
+    if (it == m_fileIds.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+FileId SymbolIndex::fileIdFor(const std::string& filePath) {
+    auto inserted = m_fileIds.emplace(filePath, static_cast<FileId>(m_filePaths.size()));
+    if (inserted.second) {
+        m_filePaths.push_back(filePath);
+        m_fileSymbols.emplace_back();
+    }
+    return inserted.first->second;
+}
+
+void SymbolIndex::indexName(const Symbol& symbol, FileId file, uint32_t offset) {
+    m_nameIndex[symbol.name].push_back({file, offset});
+}
+
 std::vector<Symbol> SymbolIndex::search(const std::string& query, bool fuzzy) const {
     if (fuzzy) {
         return fuzzySearch(query);
@@ -41,10 +130,14 @@ std::vector<Symbol> SymbolIndex::search(const std::string& query, bool fuzzy) co
 
 std::vector<Symbol> SymbolIndex::exactSearch(const std::string& query) const {
     std::vector<Symbol> results;
-    for (const auto& symbol : symbols) {
-        if (symbol.name == query) {
-            results.push_back(symbol);
-        }
+    auto refs = m_nameIndex.find(query);
+    if (refs == m_nameIndex.end()) {
+        return results;
+    }
+    
+    results.reserve(refs->second.size());
+    for (const NameRef& ref : refs->second) {
+        results.push_back(m_fileSymbols[ref.file][ref.offset]);
     }
     return results;
 }
@@ -52,29 +145,31 @@ std::vector<Symbol> SymbolIndex::exactSearch(const std::string& query) const {
 std::vector<Symbol> SymbolIndex::fuzzySearch(const std::string& query) const {
     std::vector<std::pair<Symbol, int>> scored_results;
     
-    for (const auto& symbol : symbols) {
-        // Check for exact match first
-        if (symbol.name == query) {
-            scored_results.push_back({symbol, 0});
-            continue;
-        }
-        
-        // Check for prefix match
-        if (isPrefixMatch(symbol.name, query)) {
-            scored_results.push_back({symbol, 1});
-            continue;
-        }
-        
-        // Check for substring match
-        if (symbol.name.find(query) != std::string::npos) {
-            scored_results.push_back({symbol, 2});
-            continue;
-        }
-        
-        // Levenshtein distance check (only for reasonable distances)
-        int distance = levenshteinDistance(symbol.name, query);
-        if (distance <= 3 && distance < static_cast<int>(query.length())) {
-            scored_results.push_back({symbol, distance + 10});
+    for (const auto& fileSymbols : m_fileSymbols) {
+        for (const auto& symbol : fileSymbols) {
+            // Check for exact match first
+            if (symbol.name == query) {
+                scored_results.push_back({symbol, 0});
+                continue;
+            }
+            
+            // Check for prefix match
+            if (isPrefixMatch(symbol.name, query)) {
+                scored_results.push_back({symbol, 1});
+                continue;
+            }
+            
+            // Check for substring match
+            if (symbol.name.find(query) != std::string::npos) {
+                scored_results.push_back({symbol, 2});
+                continue;
+            }
+            
+            // Levenshtein distance check (only for reasonable distances)
+            int distance = levenshteinDistance(symbol.name, query);
+            if (distance <= 3 && distance < static_cast<int>(query.length())) {
+                scored_results.push_back({symbol, distance + 10});
+            }
         }
     }
     
@@ -91,15 +186,24 @@ std::vector<Symbol> SymbolIndex::fuzzySearch(const std::string& query) const {
 }
 
 void SymbolIndex::clear() {
-    symbols.clear();
+    m_fileIds.clear();
+    m_filePaths.clear();
+    m_fileSymbols.clear();
+    m_symbolCount = 0;
+    m_nameIndex.clear();
 }
 
 size_t SymbolIndex::size() const {
-    return symbols.size();
+    return m_symbolCount;
 }
 
-const std::vector<Symbol>& SymbolIndex::getSymbols() const {
-    return symbols;
+std::vector<Symbol> SymbolIndex::getSymbols() const {
+    std::vector<Symbol> all;
+    all.reserve(m_symbolCount);
+    for (const auto& fileSymbols : m_fileSymbols) {
+        all.insert(all.end(), fileSymbols.begin(), fileSymbols.end());
+    }
+    return all;
 }
 
 bool SymbolIndex::isTypeScriptOrJavaScript(const std::string& filePath) const {
@@ -162,14 +266,6 @@ bool SymbolIndex::isRust(const std::string& filePath) const {
 }
 
 void SymbolIndex::parseFile(const std::string& filePath) {
-    std::unique_ptr<FileTimer> timer;
-    size_t symbolCountBefore = symbols.size();
-    
-    if (m_logger) {
-        timer = std::make_unique<FileTimer>(*m_logger, filePath);
-        timer->setLanguage(getLanguageFromPath(filePath));
-    }
-    
     std::ifstream file(filePath);
     if (!file.is_open()) {
         if (m_logger) {
@@ -178,10 +274,22 @@ void SymbolIndex::parseFile(const std::string& filePath) {
         return;
     }
     
+    parseStream(file, filePath);
+}
+
+void SymbolIndex::parseStream(std::istream& input, const std::string& filePath) {
+    std::unique_ptr<FileTimer> timer;
+    size_t symbolCountBefore = m_symbolCount;
+    
+    if (m_logger) {
+        timer = std::make_unique<FileTimer>(*m_logger, filePath);
+        timer->setLanguage(getLanguageFromPath(filePath));
+    }
+    
     std::string line;
     int lineNumber = 1;
     
-    while (std::getline(file, line)) {
+    while (std::getline(input, line)) {
         // Remove leading whitespace for parsing
         std::string trimmed = line;
         trimmed.erase(trimmed.begin(), std::find_if(trimmed.begin(), trimmed.end(),
@@ -225,7 +333,7 @@ void SymbolIndex::parseFile(const std::string& filePath) {
     
     // Update performance metrics
     if (timer) {
-        size_t symbolsFound = symbols.size() - symbolCountBefore;
+        size_t symbolsFound = m_symbolCount - symbolCountBefore;
         timer->setSymbolCount(symbolsFound);
     }
 }
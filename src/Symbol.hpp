@@ -3,6 +3,9 @@
 
 #include <string>
 #include <vector>
+#include <istream>
+#include <unordered_map>
+#include <cstdint>
 
 // Forward declaration
 class PerformanceLogger;
@@ -92,9 +95,36 @@ struct Symbol {
         : name(n), type(t), file(f), line(l), context(c) {}
 };
 
+// View of a contiguous run of symbols owned by a SymbolIndex; valid until the
+// index is next modified
+struct SymbolSlice {
+    const Symbol* first = nullptr;
+    size_t count = 0;
+    
+    const Symbol* begin() const { return first; }
+    const Symbol* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Symbol& operator[](size_t i) const { return first[i]; }
+};
+
+using FileId = uint32_t;
+
 class SymbolIndex {
 private:
-    std::vector<Symbol> symbols;
+    // Each file's symbols live in their own vector, so replacing one file
+    // costs that file's size and never moves another file's symbols
+    std::unordered_map<std::string, FileId> m_fileIds;
+    std::vector<std::string> m_filePaths;           // file id -> path
+    std::vector<std::vector<Symbol>> m_fileSymbols; // file id -> symbols
+    size_t m_symbolCount;
+    
+    // Exact name -> (file, offset within the file's symbols)
+    struct NameRef {
+        FileId file;
+        uint32_t offset;
+    };
+    std::unordered_map<std::string, std::vector<NameRef>> m_nameIndex;
     PerformanceLogger* m_logger; // Optional performance logger
     
 public:
@@ -107,6 +137,10 @@ public:
     // Core functionality
     void addSymbol(const Symbol& symbol);
     void buildIndex(const std::vector<std::string>& files);
+    void indexFile(const std::string& filePath); // Parse one file, appending its symbols
+    void indexText(const std::string& filePath, const std::string& text); // Same, from an in-memory buffer
+    size_t removeFile(const std::string& filePath);
+    void updateFile(const std::string& filePath, const std::vector<Symbol>& fileSymbols);
     std::vector<Symbol> search(const std::string& query, bool fuzzy = true) const;
     std::vector<Symbol> exactSearch(const std::string& query) const;
     std::vector<Symbol> fuzzySearch(const std::string& query) const;
@@ -114,11 +148,23 @@ public:
     size_t size() const;
     std::string symbolTypeToString(SymbolType type) const;
     
-    // Access to symbols for autocomplete
-    const std::vector<Symbol>& getSymbols() const;
+    // Copy of every symbol, file by file, e.g. to build the autocomplete index.
+    // Prefer getFileSymbols to walk the index without copying.
+    std::vector<Symbol> getSymbols() const;
+    
+    // Per-file access without scanning the whole index. Ids are stable for the
+    // life of the index; a removed file keeps its id with an empty slice.
+    SymbolSlice getFileSymbols(const std::string& filePath) const;
+    SymbolSlice getFileSymbols(FileId id) const;
+    bool findFileId(const std::string& filePath, FileId& id) const;
+    const std::string& getFilePath(FileId id) const { return m_filePaths[id]; }
+    size_t getFileCount() const { return m_filePaths.size(); }
     
 private:
     void parseFile(const std::string& filePath);
+    void parseStream(std::istream& input, const std::string& filePath);
+    FileId fileIdFor(const std::string& filePath);
+    void indexName(const Symbol& symbol, FileId file, uint32_t offset);
     void parseLineForSymbols(const std::string& line, const std::string& filePath, int lineNumber);
     void parseTypeScriptJavaScript(const std::string& line, const std::string& filePath, int lineNumber);
     void parsePython(const std::string& line, const std::string& filePath, int lineNumber);
@@ -0,0 +1,122 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : m_stopping(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+    
+    if (count == 1 || m_workers.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+    
+    // Shared between the caller and helper tasks; helpers that start late
+    // find no work left and never touch `task`
+    struct Batch {
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::exception_ptr error;
+    };
+    auto batch = std::make_shared<Batch>();
+    
+    auto runItems = [batch, count, &task]() {
+        size_t i;
+        while ((i = batch->next++) < count) {
+            std::exception_ptr error;
+            try {
+                task(i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            
+            std::lock_guard<std::mutex> lock(batch->mutex);
+            if (error && !batch->error) {
+                batch->error = error;
+            }
+            if (++batch->done == count) {
+                batch->finished.notify_all();
+            }
+        }
+    };
+    
+    size_t helpers = std::min(count - 1, m_workers.size());
+    for (size_t i = 0; i < helpers; ++i) {
+        enqueue(runItems);
+    }
+    
+    runItems();
+    
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&]() { return batch->done == count; });
+    
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return m_workers.size();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            
+            if (m_stopping && m_tasks.empty()) {
+                return;
+            }
+            
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        
+        task();
+    }
+}
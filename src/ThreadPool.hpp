@@ -0,0 +1,41 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Persistent worker pool shared by query and indexing code paths.
+// Workers are created once and reused, so per-call cost is a queue push.
+class ThreadPool {
+public:
+    // threadCount == 0 uses std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // Queue a fire-and-forget task
+    void enqueue(std::function<void()> task);
+    
+    // Run task(i) for every i in [0, count) and block until all are done.
+    // The calling thread takes part, so nested calls from a worker cannot deadlock.
+    void parallelFor(size_t count, const std::function<void(size_t)>& task);
+    
+    size_t getThreadCount() const;
+    
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+    
+    void workerLoop();
+};
+
+#endif // THREADPOOL_HPP
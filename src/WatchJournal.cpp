@@ -0,0 +1,439 @@
+#include "WatchJournal.hpp"
+#include "ThreadPool.hpp"
+#include "BinaryFormat.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'N', 'A', 'V', 'I', 'X', 'S', '0', '1'};
+const char JOURNAL_MAGIC[8] = {'N', 'A', 'V', 'I', 'X', 'J', '0', '1'};
+
+// Compact once the journal holds more records than this or than the snapshot has entries
+const size_t MIN_COMPACT_RECORDS = 4096;
+
+} // namespace
+
+WatchJournal::WatchJournal(const std::string& directory, const std::string& rootPath)
+    : m_directory(directory)
+    , m_rootPath(rootPath)
+    , m_hasState(false)
+    , m_journalFd(-1)
+    , m_journalRecords(0)
+    , m_unsynced(false)
+{
+}
+
+WatchJournal::~WatchJournal() {
+    close();
+}
+
+bool WatchJournal::open() {
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        std::cerr << "⚠️  Cannot create watch journal in " << m_directory << ": " << ec.message() << "\n";
+        return false;
+    }
+
+    m_state.clear();
+    m_journalRecords = 0;
+    m_hasState = loadSnapshot();
+    if (m_hasState) {
+        replayJournal();
+    }
+
+    // Keep appending after the last intact record
+    return openJournal(!m_hasState);
+}
+
+void WatchJournal::close() {
+    sync();
+    if (m_journalFd >= 0) {
+        ::close(m_journalFd);
+        m_journalFd = -1;
+    }
+}
+
+bool WatchJournal::hasState() const {
+    return m_hasState;
+}
+
+const WatchJournal::FileTable& WatchJournal::getState() const {
+    return m_state;
+}
+
+void WatchJournal::append(const std::vector<FileChange>& changes) {
+    if (m_journalFd < 0) {
+        return;
+    }
+
+    // One buffered write per batch; each record is framed [length][checksum][payload]
+    std::string buffer;
+    for (const auto& change : changes) {
+        FileState state{0, 0};
+        if (change.event != FileEvent::DELETED) {
+            statFile(change.path, state);
+        }
+
+        std::string payload;
+        putValue<uint8_t>(payload, static_cast<uint8_t>(change.event));
+        putValue<int64_t>(payload, state.mtime);
+        putValue<uint64_t>(payload, state.size);
+        putString(payload, relativePath(change.path));
+        putString(payload, change.event == FileEvent::MOVED ? relativePath(change.oldPath) : "");
+
+        putValue<uint32_t>(buffer, static_cast<uint32_t>(payload.size()));
+        putValue<uint32_t>(buffer, checksum(payload));
+        buffer.append(payload);
+
+        applyRecord(change.event, change.path, change.oldPath, state);
+        m_journalRecords++;
+    }
+
+    // A torn write is cut off on replay; durability comes with the next sync
+    if (!writeAll(m_journalFd, buffer.data(), buffer.size())) {
+        std::cerr << "⚠️  Cannot write watch journal: " << std::strerror(errno) << "\n";
+        return;
+    }
+    m_unsynced = true;
+    syncIfDue();
+}
+
+void WatchJournal::sync() {
+    if (!m_unsynced || m_journalFd < 0) {
+        return;
+    }
+    if (::fsync(m_journalFd) != 0) {
+        std::cerr << "⚠️  Cannot sync watch journal: " << std::strerror(errno) << "\n";
+    }
+    m_unsynced = false;
+    m_lastSync = std::chrono::steady_clock::now();
+}
+
+void WatchJournal::syncIfDue() {
+    // Group commit: one fsync covers every batch written since the last one
+    if (m_unsynced && std::chrono::steady_clock::now() - m_lastSync >= SYNC_INTERVAL) {
+        sync();
+    }
+}
+
+bool WatchJournal::writeSnapshot(const FileTable& files) {
+    std::string buffer(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    putValue<uint64_t>(buffer, files.size());
+    for (const auto& entry : files) {
+        putString(buffer, relativePath(entry.first));
+        putValue<int64_t>(buffer, entry.second.mtime);
+        putValue<uint64_t>(buffer, entry.second.size);
+    }
+    putValue<uint32_t>(buffer, checksum(buffer));
+
+    if (!replaceFile(snapshotPath(), buffer)) {
+        return false;
+    }
+
+    if (&files != &m_state) {
+        m_state = files;
+    }
+    m_hasState = true;
+    m_journalRecords = 0;
+
+    // The snapshot covers everything the old journal held
+    m_unsynced = false;
+    return openJournal(true);
+}
+
+bool WatchJournal::needsSnapshot() const {
+    return m_journalRecords >= std::max(MIN_COMPACT_RECORDS, m_state.size());
+}
+
+std::vector<FileChange> WatchJournal::diff(const FileTable& current) const {
+    std::vector<FileChange> changes;
+
+    for (const auto& entry : current) {
+        auto known = m_state.find(entry.first);
+        if (known == m_state.end()) {
+            changes.emplace_back(entry.first, FileEvent::CREATED);
+        } else if (known->second != entry.second) {
+            changes.emplace_back(entry.first, FileEvent::MODIFIED);
+        }
+    }
+
+    for (const auto& entry : m_state) {
+        if (!current.count(entry.first)) {
+            changes.emplace_back(entry.first, FileEvent::DELETED);
+        }
+    }
+
+    return changes;
+}
+
+WatchJournal::FileTable WatchJournal::statFiles(const std::vector<std::string>& paths, ThreadPool& pool) {
+    std::vector<FileState> states(paths.size());
+    std::vector<char> present(paths.size(), 0);
+
+    // stat latency dominates on cold caches and network mounts, so overlap the calls
+    const size_t chunk = 256;
+    pool.parallelFor((paths.size() + chunk - 1) / chunk, [&](size_t block) {
+        size_t end = std::min(paths.size(), (block + 1) * chunk);
+        for (size_t i = block * chunk; i < end; i++) {
+            present[i] = statFile(paths[i], states[i]);
+        }
+    });
+
+    FileTable files;
+    files.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (present[i]) {
+            files.emplace(paths[i], states[i]);
+        }
+    }
+    return files;
+}
+
+std::string WatchJournal::defaultDirectory(const std::string& rootPath) {
+    std::string base;
+    if (const char* cache = std::getenv("XDG_CACHE_HOME")) {
+        base = cache;
+    } else if (const char* home = std::getenv("HOME")) {
+        base = std::string(home) + "/.cache";
+    } else {
+        base = std::filesystem::temp_directory_path().string();
+    }
+
+    std::error_code ec;
+    std::string canonical = std::filesystem::weakly_canonical(rootPath, ec).string();
+    if (ec) {
+        canonical = rootPath;
+    }
+
+    std::ostringstream oss;
+    oss << base << "/navix/journal-" << std::hex << std::setw(16) << std::setfill('0')
+        << std::hash<std::string>{}(canonical);
+    return oss.str();
+}
+
+std::string WatchJournal::snapshotPath() const {
+    return m_directory + "/snapshot";
+}
+
+std::string WatchJournal::journalPath() const {
+    return m_directory + "/journal";
+}
+
+std::string WatchJournal::relativePath(const std::string& path) const {
+    // Stored relative to the root so the journal survives the tree moving
+    if (path.size() > m_rootPath.size() && path.compare(0, m_rootPath.size(), m_rootPath) == 0 &&
+        path[m_rootPath.size()] == '/') {
+        return path.substr(m_rootPath.size() + 1);
+    }
+    return path;
+}
+
+std::string WatchJournal::absolutePath(const std::string& relative) const {
+    if (!relative.empty() && relative[0] == '/') {
+        return relative;
+    }
+    return m_rootPath + "/" + relative;
+}
+
+bool WatchJournal::loadSnapshot() {
+    std::ifstream in(snapshotPath(), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (buffer.size() < sizeof(SNAPSHOT_MAGIC) + sizeof(uint64_t) + sizeof(uint32_t) ||
+        std::memcmp(buffer.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        return false;
+    }
+
+    size_t bodySize = buffer.size() - sizeof(uint32_t);
+    uint32_t stored;
+    std::memcpy(&stored, buffer.data() + bodySize, sizeof(stored));
+    if (stored != checksum(buffer.substr(0, bodySize))) {
+        std::cerr << "⚠️  Watch journal snapshot is corrupt, starting fresh\n";
+        return false;
+    }
+
+    BinaryReader reader(buffer.data() + sizeof(SNAPSHOT_MAGIC), bodySize - sizeof(SNAPSHOT_MAGIC));
+    uint64_t count = reader.value<uint64_t>();
+    for (uint64_t i = 0; i < count && reader.ok(); i++) {
+        std::string path = reader.string();
+        FileState state;
+        state.mtime = reader.value<int64_t>();
+        state.size = reader.value<uint64_t>();
+        if (reader.ok()) {
+            m_state.emplace(absolutePath(path), state);
+        }
+    }
+
+    return reader.ok();
+}
+
+void WatchJournal::replayJournal() {
+    std::ifstream in(journalPath(), std::ios::binary);
+    if (!in) {
+        return;
+    }
+
+    std::string buffer((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (buffer.size() < sizeof(JOURNAL_MAGIC) ||
+        std::memcmp(buffer.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        return;
+    }
+
+    size_t offset = sizeof(JOURNAL_MAGIC);
+    const size_t headerSize = 2 * sizeof(uint32_t);
+    while (offset + headerSize <= buffer.size()) {
+        uint32_t length;
+        uint32_t stored;
+        std::memcpy(&length, buffer.data() + offset, sizeof(length));
+        std::memcpy(&stored, buffer.data() + offset + sizeof(length), sizeof(stored));
+        if (offset + headerSize + length > buffer.size()) {
+            break;
+        }
+
+        std::string payload = buffer.substr(offset + headerSize, length);
+        if (checksum(payload) != stored) {
+            break;
+        }
+
+        BinaryReader reader(payload.data(), payload.size());
+        auto event = static_cast<FileEvent>(reader.value<uint8_t>());
+        FileState state;
+        state.mtime = reader.value<int64_t>();
+        state.size = reader.value<uint64_t>();
+        std::string path = reader.string();
+        std::string oldPath = reader.string();
+        if (!reader.ok()) {
+            break;
+        }
+
+        applyRecord(event, absolutePath(path), oldPath.empty() ? "" : absolutePath(oldPath), state);
+        m_journalRecords++;
+        offset += headerSize + length;
+    }
+
+    // Drop a torn tail so new records do not land behind garbage
+    if (offset < buffer.size()) {
+        std::error_code ec;
+        std::filesystem::resize_file(journalPath(), offset, ec);
+    }
+}
+
+void WatchJournal::applyRecord(FileEvent event, const std::string& path, const std::string& oldPath,
+                               FileState state) {
+    switch (event) {
+        case FileEvent::DELETED:
+            m_state.erase(path);
+            break;
+        case FileEvent::MOVED:
+            m_state.erase(oldPath);
+            m_state[path] = state;
+            break;
+        case FileEvent::CREATED:
+        case FileEvent::MODIFIED:
+            m_state[path] = state;
+            break;
+    }
+}
+
+bool WatchJournal::openJournal(bool truncate) {
+    close();
+
+    std::error_code ec;
+    if (!truncate && std::filesystem::file_size(journalPath(), ec) >= sizeof(JOURNAL_MAGIC)) {
+        m_journalFd = ::open(journalPath().c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+        return m_journalFd >= 0;
+    }
+
+    m_journalFd = ::open(journalPath().c_str(), O_WRONLY | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_journalFd < 0) {
+        return false;
+    }
+    if (!writeAll(m_journalFd, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) || ::fsync(m_journalFd) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool WatchJournal::statFile(const std::string& path, FileState& state) {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+
+    state.mtime = mtime.time_since_epoch().count();
+    state.size = size;
+    return true;
+}
+
+bool WatchJournal::writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool WatchJournal::replaceFile(const std::string& path, const std::string& data) {
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    // Without the fsync the rename can reach disk before the data does
+    bool written = writeAll(fd, data.data(), data.size()) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!written) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        return false;
+    }
+
+    // Persist the rename itself
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+uint32_t WatchJournal::checksum(const std::string& data) {
+    // FNV-1a: catches torn and partially overwritten records, not tampering
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
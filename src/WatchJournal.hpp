@@ -0,0 +1,103 @@
+#ifndef WATCHJOURNAL_HPP
+#define WATCHJOURNAL_HPP
+
+#include "FileWatcher.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <cstdint>
+
+class ThreadPool;
+
+// On-disk record of what the watcher has delivered, so a restarted watcher
+// can report only what changed while it was down.
+//
+// Two files live in the journal directory:
+//   snapshot  full (path, mtime, size) table, replaced atomically via rename
+//   journal   events delivered since that snapshot, appended per batch
+// Every journal record carries its length and a checksum; replay stops at the
+// first torn or corrupt record. Batches are written as they arrive but fsync'ed
+// at most once per SYNC_INTERVAL, so a crash loses at most the last interval,
+// whose files the next start then reports as changed again.
+class WatchJournal {
+public:
+    struct FileState {
+        int64_t mtime;
+        uint64_t size;
+        bool operator==(const FileState& other) const { return mtime == other.mtime && size == other.size; }
+        bool operator!=(const FileState& other) const { return !(*this == other); }
+    };
+    using FileTable = std::unordered_map<std::string, FileState>;
+
+    WatchJournal(const std::string& directory, const std::string& rootPath);
+    ~WatchJournal();
+
+    WatchJournal(const WatchJournal&) = delete;
+    WatchJournal& operator=(const WatchJournal&) = delete;
+
+    // Load the snapshot and replay the journal on top of it
+    bool open();
+    void close();
+
+    // False on the first run for this root: there is nothing to diff against
+    bool hasState() const;
+    const FileTable& getState() const;
+
+    // Record a delivered batch; the files are stat'ed now
+    void append(const std::vector<FileChange>& changes);
+
+    // fsync what append wrote, now or only once SYNC_INTERVAL has passed
+    void sync();
+    void syncIfDue();
+
+    // Replace the snapshot with the given table and start an empty journal
+    bool writeSnapshot(const FileTable& files);
+
+    // Compact once the journal outgrows the snapshot it sits on
+    bool needsSnapshot() const;
+
+    // Changes that turn the recorded state into the current one
+    std::vector<FileChange> diff(const FileTable& current) const;
+
+    // (mtime, size) of every path, stat'ed in parallel on the caller's pool;
+    // missing files are left out
+    static FileTable statFiles(const std::vector<std::string>& paths, ThreadPool& pool);
+
+    // Per-root directory under $XDG_CACHE_HOME/navix (or ~/.cache/navix)
+    static std::string defaultDirectory(const std::string& rootPath);
+
+    // FNV-1a over a record, shared with the other files in the directory
+    static uint32_t checksum(const std::string& data);
+
+    // Write aside, fsync and rename over path, so a crash leaves either the
+    // old or the new contents on disk
+    static bool replaceFile(const std::string& path, const std::string& data);
+
+private:
+    static constexpr std::chrono::milliseconds SYNC_INTERVAL{1000};
+
+    std::string m_directory;
+    std::string m_rootPath;
+    FileTable m_state;
+    bool m_hasState;
+    int m_journalFd;
+    size_t m_journalRecords;
+    bool m_unsynced;
+    std::chrono::steady_clock::time_point m_lastSync;
+
+    std::string snapshotPath() const;
+    std::string journalPath() const;
+    std::string relativePath(const std::string& path) const;
+    std::string absolutePath(const std::string& relative) const;
+
+    bool loadSnapshot();
+    void replayJournal();
+    void applyRecord(FileEvent event, const std::string& path, const std::string& oldPath, FileState state);
+    bool openJournal(bool truncate);
+
+    static bool statFile(const std::string& path, FileState& state);
+    static bool writeAll(int fd, const char* data, size_t size);
+};
+
+#endif // WATCHJOURNAL_HPP
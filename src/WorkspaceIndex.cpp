@@ -0,0 +1,84 @@
+#include "WorkspaceIndex.hpp"
+#include <fstream>
+#include <sstream>
+
+WorkspaceIndex::FileUpdate WorkspaceIndex::FileUpdate::fromText(const std::string& path, const std::string& text) {
+    FileUpdate update;
+    update.path = path;
+
+    SymbolIndex parsed;
+    parsed.indexText(path, text);
+    update.symbols = parsed.getSymbols();
+    update.tokens = IdentifierIndex::tokenize(text);
+    return update;
+}
+
+WorkspaceIndex::FileUpdate WorkspaceIndex::FileUpdate::fromDisk(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return removal(path);
+    }
+
+    std::ostringstream text;
+    text << file.rdbuf();
+    return fromText(path, text.str());
+}
+
+WorkspaceIndex::FileUpdate WorkspaceIndex::FileUpdate::removal(const std::string& path) {
+    FileUpdate update;
+    update.path = path;
+    return update;
+}
+
+WorkspaceIndex::WorkspaceIndex() {
+    m_completions.setVerbose(false);
+
+    // Queries are already spread over the server's pool; keep scoring serial
+    // unless the index is large enough for partitions to pay off
+    m_completions.setThreadCount(2);
+}
+
+void WorkspaceIndex::build(const std::vector<FileUpdate>& files) {
+    {
+        std::lock_guard<std::mutex> lock(m_outlineMutex);
+        m_outlines.clear();
+    }
+
+    m_symbols.clear();
+    m_identifiers.clear();
+    for (const FileUpdate& file : files) {
+        m_symbols.updateFile(file.path, file.symbols);
+        m_identifiers.updateFile(file.path, file.tokens);
+    }
+    m_completions.buildIndex(m_symbols.getSymbols());
+}
+
+void WorkspaceIndex::updateFile(const FileUpdate& update) {
+    {
+        std::lock_guard<std::mutex> lock(m_outlineMutex);
+        m_outlines.erase(update.path);
+    }
+
+    m_symbols.updateFile(update.path, update.symbols);
+    m_identifiers.updateFile(update.path, update.tokens);
+    if (update.symbols.empty()) {
+        m_completions.removeFile(update.path);
+    } else {
+        m_completions.updateFile(update.path, update.symbols);
+    }
+}
+
+bool WorkspaceIndex::findCachedOutline(const std::string& filePath, std::string& json) const {
+    std::lock_guard<std::mutex> lock(m_outlineMutex);
+    auto it = m_outlines.find(filePath);
+    if (it == m_outlines.end()) {
+        return false;
+    }
+    json = it->second;
+    return true;
+}
+
+void WorkspaceIndex::cacheOutline(const std::string& filePath, const std::string& json) const {
+    std::lock_guard<std::mutex> lock(m_outlineMutex);
+    m_outlines[filePath] = json;
+}
@@ -0,0 +1,59 @@
+#ifndef WORKSPACEINDEX_HPP
+#define WORKSPACEINDEX_HPP
+
+#include "Symbol.hpp"
+#include "AutocompleteEngine.hpp"
+#include "IdentifierIndex.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+// Everything the LSP server answers queries from: the flat symbol list for
+// per-document exports and definitions, the ranked completion engine for
+// workspace/symbol and the identifier occurrences for references. All three
+// are updated together, one file at a time.
+class WorkspaceIndex {
+public:
+    // One file's parsed contents. Parsing happens once; the result can then be
+    // applied to several indexes (the server keeps two).
+    struct FileUpdate {
+        std::string path;
+        std::vector<Symbol> symbols;
+        IdentifierIndex::FileTokens tokens;
+
+        static FileUpdate fromText(const std::string& path, const std::string& text);
+        static FileUpdate fromDisk(const std::string& path);  // a removal if unreadable
+        static FileUpdate removal(const std::string& path);
+    };
+
+    WorkspaceIndex();
+
+    WorkspaceIndex(const WorkspaceIndex&) = delete;
+    WorkspaceIndex& operator=(const WorkspaceIndex&) = delete;
+
+    void build(const std::vector<FileUpdate>& files);
+
+    // Replace one file's contents; an update with no symbols and no tokens removes the file
+    void updateFile(const FileUpdate& update);
+
+    const SymbolIndex& getSymbols() const { return m_symbols; }
+    const AutocompleteEngine& getCompletions() const { return m_completions; }
+    const IdentifierIndex& getIdentifiers() const { return m_identifiers; }
+    size_t size() const { return m_symbols.size(); }
+
+    // Serialized documentSymbol responses. An entry lives until its file next
+    // changes in this index, so it always matches the snapshot it came from.
+    bool findCachedOutline(const std::string& filePath, std::string& json) const;
+    void cacheOutline(const std::string& filePath, const std::string& json) const;
+
+private:
+    SymbolIndex m_symbols;
+    AutocompleteEngine m_completions;
+    IdentifierIndex m_identifiers;
+
+    mutable std::unordered_map<std::string, std::string> m_outlines;
+    mutable std::mutex m_outlineMutex;
+};
+
+#endif // WORKSPACEINDEX_HPP
@@ -15,6 +15,11 @@
 #include "AutocompleteEngine.hpp"
 #include "JsonExporter.hpp"
 #include "LSPServer.hpp"
+#include "NavixDaemon.hpp"
+#include "DaemonClient.hpp"
+#include "IndexWorker.hpp"
+#include "WatchJournal.hpp"
+#include "IndexSnapshot.hpp"
 
 
 // Version information
@@ -61,8 +66,11 @@ void printUsage(const char* programName) {
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --tui") << "  Interactive TUI mode        │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --autocomplete") << "  Interactive autocomplete    │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --complete <query>") << "  Get completions for query   │\n";
+    std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --complete <q> --threads <n>") << "  Completion scoring threads  │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --live") << "  Live file watching mode     │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --watch") << "  Same as --live              │\n";
+    std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --live --fanotify") << "  Watch via fanotify (root)   │\n";
+    std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --live --poll") << "  Poll (network filesystems)  │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --perf") << "  Enable performance logging │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --cpp") << "  Scan C++ files only         │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --ts") << "  Scan TypeScript/JS files    │\n";
@@ -81,6 +89,7 @@ void printUsage(const char* programName) {
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --export-tags") << "  Export ctags file           │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --json [file]") << "  Export symbols to JSON      │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --lsp") << "  Start LSP server mode       │\n";
+    std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --daemon") << "  Shared index for LSP + CLI  │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --json-compact") << "  Export compact JSON         │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --json-stats") << "  Export JSON with stats      │\n";
     std::cout << "│ " << std::left << std::setw(40) << (std::string(programName) + " <root> --json-lsp") << "  Export LSP-compatible JSON  │\n";
@@ -113,6 +122,7 @@ void printUsage(const char* programName) {
     std::cout << "│ " << std::left << std::setw(45) << (std::string(programName) + " . --export-tags") << "    Generate tags       │\n";
     std::cout << "│ " << std::left << std::setw(45) << (std::string(programName) + " . --json symbols.json") << " Export to JSON      │\n";
     std::cout << "│ " << std::left << std::setw(45) << (std::string(programName) + " . --lsp") << "               Start LSP server    │\n";
+    std::cout << "│ " << std::left << std::setw(45) << (std::string(programName) + " . --daemon") << "            Background daemon   │\n";
     std::cout << "│ " << std::left << std::setw(45) << (std::string(programName) + " . --json-compact") << "     Compact JSON export │\n";
     std::cout << "│ " << std::left << std::setw(45) << (std::string(programName) + " . --json-lsp") << "        LSP-compatible JSON │\n";
     std::cout << "└────────────────────────────────────────────────────────────────────────────┘\n\n";
@@ -233,87 +243,156 @@ void printSymbolResults(const std::vector<Symbol>& symbols, const SymbolIndex& i
     }
 }
 
+// Read "--threads <n>" from the optional flags after a mode; 0 means one per hardware thread
+size_t parseThreadCount(int argc, char* argv[], int firstFlag) {
+    for (int i = firstFlag; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--threads") {
+            try {
+                return static_cast<size_t>(std::stoul(argv[i + 1]));
+            } catch (const std::exception&) {
+                std::cerr << "⚠️  Ignoring invalid thread count: " << argv[i + 1] << "\n";
+            }
+        }
+    }
+    return 0;
+}
+
 // Live mode implementation
-void runLiveMode(const std::string& rootPath, bool enablePerformance = false, bool verbose = false) {
+void runLiveMode(const std::string& rootPath, bool enablePerformance = false, bool verbose = false, 
+                 bool useFanotify = false, bool usePolling = false) {
     std::cout << "🔄 Starting Live Mode with real-time file watching...\n\n";
     
     // Setup performance logger
     PerformanceLogger perfLogger;
     if (enablePerformance) {
         perfLogger.setVerbose(verbose);
-        perfLogger.setLogToFile(true, "navix_live_performance.log");
+        // Log next to the watch journal, not into whatever directory navix ran from
+        std::string logDirectory = WatchJournal::defaultDirectory(rootPath);
+        std::error_code ec;
+        std::filesystem::create_directories(logDirectory, ec);
+        std::string logPath = logDirectory + "/live_performance.log";
+        perfLogger.setLogToFile(true, logPath);
+        std::cout << "📝 Performance log: " << logPath << "\n";
         perfLogger.startSession("live-indexing");
     }
     
-    // Initial indexing
-    std::cout << "📊 Initial indexing...\n";
-    std::vector<std::string> allFiles = FileScanner::scanForAllSupportedFiles(rootPath);
+    // Re-index off the watcher thread; each batch publishes a new index generation.
+    // Declared first so it outlives the watcher that feeds it and borrows its pool
+    IndexWorker indexWorker;
     
-    SymbolIndex symbolIndex;
-    if (enablePerformance) {
-        symbolIndex.setPerformanceLogger(&perfLogger);
+    // Initial indexing: files whose (mtime, size) match the index snapshot are
+    // restored from it and only the rest are parsed
+    std::cout << "📊 Initial indexing...\n";
+    auto indexStarted = std::chrono::steady_clock::now();
+    std::string journalDirectory = WatchJournal::defaultDirectory(rootPath);
+    std::vector<Symbol> initialSymbols;
+    size_t fileCount = 0;
+    size_t reused = 0;
+    size_t parsedCount = 0;
+    {
+        // The watch journal holds the state of every file as last delivered.
+        // Bring the index up to that state without touching the tree; the
+        // watcher's own startup walk then reports whatever changed while we
+        // were down. Only the first run for a root scans here instead
+        WatchJournal journal(journalDirectory, rootPath);
+        bool journaled = journal.open() && journal.hasState();
+        WatchJournal::FileTable states;
+        if (journaled) {
+            states = journal.getState();
+        } else {
+            states = WatchJournal::statFiles(FileScanner::scanForAllSupportedFiles(rootPath),
+                                             indexWorker.getParsePool());
+        }
+        std::vector<std::string> allFiles;
+        allFiles.reserve(states.size());
+        for (const auto& entry : states) {
+            allFiles.push_back(entry.first);
+        }
+        
+        IndexSnapshot snapshot(journalDirectory, rootPath);
+        IndexSnapshot::Entries entries;
+        snapshot.load(entries);
+        std::vector<std::string> stale;
+        bool snapshotChanged = IndexSnapshot::reconcile(entries, allFiles, states, stale);
+        reused = entries.size();
+        parsedCount = stale.size();
+        
+        // Recorded at the journal's state; if the file has moved on since,
+        // the watcher's catch-up reports it and it is parsed once more
+        std::vector<WorkspaceIndex::FileUpdate> parsed(stale.size());
+        indexWorker.getParsePool().parallelFor(stale.size(), [&](size_t i) {
+            parsed[i] = WorkspaceIndex::FileUpdate::fromDisk(stale[i]);
+        });
+        for (size_t i = 0; i < stale.size(); i++) {
+            entries[stale[i]] = IndexSnapshot::Entry{states[stale[i]], std::move(parsed[i])};
+        }
+        if (snapshotChanged) {
+            if (!snapshot.save(entries)) {
+                std::cerr << "⚠️  Could not write the index snapshot to " << journalDirectory << "\n";
+            }
+        }
+        
+        // First run: the scan is the baseline the watcher diffs against
+        if (!journaled) {
+            journal.writeSnapshot(states);
+        }
+        
+        fileCount = entries.size();
+        for (const auto& entry : entries) {
+            const auto& symbols = entry.second.update.symbols;
+            initialSymbols.insert(initialSymbols.end(), symbols.begin(), symbols.end());
+        }
     }
     
-    symbolIndex.buildIndex(allFiles);
+    auto indexElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - indexStarted);
+    std::cout << "✅ Initial index built: " << initialSymbols.size() << " symbols from " 
+              << fileCount << " files (" << reused << " from snapshot, " << parsedCount
+              << " parsed) in " << indexElapsed.count() << "ms\n\n";
     
+    // Setup file watcher
+    FileWatcher watcher;
+    watcher.setUseFanotify(useFanotify);
+    watcher.setUsePolling(usePolling);
+    watcher.setJournalDirectory(journalDirectory, indexWorker.getParsePool());
     if (enablePerformance) {
-        perfLogger.printSessionSummary();
-        perfLogger.printLanguageBreakdown();
+        indexWorker.setPerformanceLogger(&perfLogger);
     }
+    indexWorker.setPublishCallback([&](uint64_t generation, size_t fileCount, std::chrono::microseconds latency) {
+        auto engine = indexWorker.acquire();
+        std::cout << "   ✅ Generation " << generation << ": " << fileCount << " files re-indexed, "
+                  << engine->getSymbolCount() << " symbols, searchable after " 
+                  << std::fixed << std::setprecision(1) << latency.count() / 1000.0 << "ms\n";
+    });
+    indexWorker.start(initialSymbols);
     
-    std::cout << "✅ Initial index built: " << symbolIndex.size() << " symbols from " 
-              << allFiles.size() << " files\n\n";
-    
-    // Setup file watcher
-    FileWatcher watcher;
-    std::vector<std::string> extensions = {
-        ".cpp", ".hpp", ".h", ".cc", ".cxx",
-        ".ts", ".tsx", ".js", ".jsx", ".mjs", ".cjs",
-        ".py", ".pyw", ".pyi",
-        ".go",
-        ".txt", ".text", ".md", ".rst", ".log", ".readme", ".doc"
-    };
+    // Short debounce window keeps save -> searchable latency low
+    watcher.setDebounceTime(std::chrono::milliseconds(25));
     
-    // Set up change callback
-    watcher.setChangeCallback([&](const FileChange& change) {
-        std::string eventName;
-        switch (change.event) {
-            case FileEvent::CREATED: eventName = "CREATED"; break;
-            case FileEvent::MODIFIED: eventName = "MODIFIED"; break;
-            case FileEvent::DELETED: eventName = "DELETED"; break;
-            case FileEvent::MOVED: eventName = "MOVED"; break;
-        }
-        
-        std::cout << "📁 " << eventName << ": " << change.path << "\n";
-        
-        // Re-index the affected file or remove from index
-        if (change.event == FileEvent::DELETED) {
-            // TODO: Remove symbols from deleted file
-            std::cout << "   ❌ File deleted - symbols removed from index\n";
-        } else {
-            // Re-parse the file
-            if (enablePerformance) {
-                perfLogger.startSession("file-reindex");
+    watcher.setBatchCallback([&](const std::vector<FileChange>& batch) {
+        for (const auto& change : batch) {
+            std::string eventName;
+            switch (change.event) {
+                case FileEvent::CREATED: eventName = "CREATED"; break;
+                case FileEvent::MODIFIED: eventName = "MODIFIED"; break;
+                case FileEvent::DELETED: eventName = "DELETED"; break;
+                case FileEvent::MOVED: eventName = "MOVED"; break;
             }
             
-            std::vector<std::string> singleFile = {change.path};
-            SymbolIndex tempIndex;
-            if (enablePerformance) {
-                tempIndex.setPerformanceLogger(&perfLogger);
-            }
-            tempIndex.buildIndex(singleFile);
-            
-            if (enablePerformance) {
-                perfLogger.endSession();
+            if (change.event == FileEvent::MOVED) {
+                std::cout << "📁 " << eventName << ": " << change.oldPath << " → " << change.path << "\n";
+            } else {
+                std::cout << "📁 " << eventName << ": " << change.path << "\n";
             }
-            
-            std::cout << "   ✅ File re-indexed: " << tempIndex.size() << " symbols\n";
         }
+        
+        indexWorker.submit(batch);
     });
     
     // Start watching
-    if (watcher.startWatching(rootPath, extensions)) {
-        std::cout << "👀 Watching " << watcher.getWatchedFileCount() << " files for changes...\n";
+    if (watcher.startWatching(rootPath, FileScanner::getSupportedExtensions())) {
+        std::cout << "👀 Watching " << watcher.getWatchedFileCount() << " files in "
+                  << watcher.getWatchedDirectoryCount() << " directories for changes...\n";
         std::cout << "💡 Press Ctrl+C to stop\n\n";
         
         // Keep the program running and show live stats
@@ -322,7 +401,9 @@ void runLiveMode(const std::string& rootPath, bool enablePerformance = false, bo
             
             if (enablePerformance && watcher.getChangeEventCount() > 0) {
                 std::cout << "📊 Live Stats - Changes detected: " << watcher.getChangeEventCount() 
-                         << ", Files watched: " << watcher.getWatchedFileCount() << "\n";
+                         << ", Files watched: " << watcher.getWatchedFileCount() 
+                         << ", Backend: " << watcher.getBackendName() << "\n";
+                perfLogger.logWatcherStats(watcher.getStats());
             }
         }
     } else {
@@ -330,8 +411,10 @@ void runLiveMode(const std::string& rootPath, bool enablePerformance = false, bo
     }
     
     watcher.stopWatching();
+    indexWorker.stop();
     
     if (enablePerformance) {
+        perfLogger.printReindexSummary();
         perfLogger.endSession();
         std::cout << "\n📊 Final Performance Summary:\n";
         perfLogger.printSessionSummary();
@@ -401,6 +484,7 @@ int main(int argc, char* argv[]) {
             symbolIndex.buildIndex(allFiles);
             
             AutocompleteEngine autocomplete;
+            autocomplete.setThreadCount(parseThreadCount(argc, argv, 3));
             autocomplete.buildIndex(symbolIndex.getSymbols());
             autocomplete.printStatistics();
             
@@ -417,6 +501,7 @@ int main(int argc, char* argv[]) {
             symbolIndex.buildIndex(allFiles);
             
             AutocompleteEngine autocomplete;
+            autocomplete.setThreadCount(parseThreadCount(argc, argv, 4));
             autocomplete.buildIndex(symbolIndex.getSymbols());
             
             std::cout << "🔍 Getting completions for '" << query << "'...\n\n";
@@ -455,6 +540,8 @@ int main(int argc, char* argv[]) {
             // Live file watching mode
             bool enablePerformance = false;
             bool verbose = false;
+            bool useFanotify = false;
+            bool usePolling = false;
             
             // Check for additional flags
             for (int i = 3; i < argc; i++) {
@@ -463,10 +550,14 @@ int main(int argc, char* argv[]) {
                     enablePerformance = true;
                 } else if (flag == "--verbose" || flag == "-v") {
                     verbose = true;
+                } else if (flag == "--fanotify") {
+                    useFanotify = true;
+                } else if (flag == "--poll") {
+                    usePolling = true;
                 }
             }
             
-            runLiveMode(rootPath, enablePerformance, verbose);
+            runLiveMode(rootPath, enablePerformance, verbose, useFanotify, usePolling);
             return 0;
             
         } else if (mode == "--perf" || mode == "--performance") {
@@ -760,7 +851,11 @@ int main(int argc, char* argv[]) {
             std::string query = argv[3];
             std::cout << "🔍 Searching for symbols matching '" << query << "' in: " << rootPath << "\n\n";
             
-            std::vector<Symbol> symbols = FileScanner::searchSymbols(rootPath, query, true, true);
+            // A running daemon answers from its index; otherwise index now
+            std::vector<Symbol> symbols;
+            if (!DaemonClient::search(rootPath, query, true, symbols)) {
+                symbols = FileScanner::searchSymbols(rootPath, query, true, true);
+            }
             SymbolIndex tempIndex; // For the symbolTypeToString method
             printSymbolResults(symbols, tempIndex, true); // Use new format
             
@@ -769,7 +864,10 @@ int main(int argc, char* argv[]) {
             std::string query = argv[3];
             std::cout << "🎯 Searching for exact symbol '" << query << "' in: " << rootPath << "\n\n";
             
-            std::vector<Symbol> symbols = FileScanner::searchSymbols(rootPath, query, false, true);
+            std::vector<Symbol> symbols;
+            if (!DaemonClient::search(rootPath, query, false, symbols)) {
+                symbols = FileScanner::searchSymbols(rootPath, query, false, true);
+            }
             SymbolIndex tempIndex; // For the symbolTypeToString method
             printSymbolResults(symbols, tempIndex, true); // Use new format
             
@@ -780,7 +878,21 @@ int main(int argc, char* argv[]) {
             
             std::cout << "🚀 Looking for symbol '" << symbolName << "' in: " << rootPath << "\n\n";
             
-            if (!FileScanner::gotoSymbol(rootPath, symbolName, editor)) {
+            // Same lookup as gotoSymbol, exact first, but against the daemon's index
+            std::vector<Symbol> symbols;
+            if (DaemonClient::search(rootPath, symbolName, false, symbols)) {
+                if (symbols.empty()) {
+                    DaemonClient::search(rootPath, symbolName, true, symbols);
+                }
+                if (symbols.empty()) {
+                    std::cout << "❌ Symbol '" << symbolName << "' not found.\n";
+                    return 1;
+                }
+                std::cout << "✅ Found: " << FileScanner::formatSymbolLocation(symbols[0]) << "\n";
+                if (!FileScanner::openInEditor(symbols[0].file, symbols[0].line, editor)) {
+                    return 1;
+                }
+            } else if (!FileScanner::gotoSymbol(rootPath, symbolName, editor)) {
                 return 1;
             }
             
@@ -889,10 +1001,16 @@ int main(int argc, char* argv[]) {
             }
             
         } else if (mode == "--lsp") {
-            std::cout << "🛠️  Starting Navix LSP Server\n";
-            std::cout << "📁 Workspace: " << rootPath << "\n";
-            std::cout << "🔗 LSP Protocol: Language Server Protocol v3.17\n";
-            std::cout << "🚀 Ready for IDE/Editor connections...\n\n";
+            // With a daemon running, this process only relays the session to it
+            if (DaemonClient::proxyLSP(rootPath)) {
+                return 0;
+            }
+            
+            // stdout carries the protocol; the banner goes to stderr
+            std::cerr << "🛠️  Starting Navix LSP Server\n";
+            std::cerr << "📁 Workspace: " << rootPath << "\n";
+            std::cerr << "🔗 LSP Protocol: Language Server Protocol v3.17\n";
+            std::cerr << "🚀 Ready for IDE/Editor connections...\n\n";
             
             LSPServer server;
             server.setWorkspaceRoot(rootPath);
@@ -905,6 +1023,17 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
             
+        } else if (mode == "--daemon") {
+            NavixDaemon daemon(rootPath);
+            if (!daemon.start()) {
+                return 1;
+            }
+            
+            std::cerr << "🛰️  Navix daemon serving " << rootPath << "\n";
+            std::cerr << "🔌 Socket: " << NavixDaemon::socketPath(rootPath) << "\n";
+            std::cerr << "💡 --lsp, --search, --search-exact and --goto on this root now use it; Ctrl+C to stop\n\n";
+            daemon.run();
+            
         } else if (mode == "--search" && argc > 3) {
             // Symbol search (fuzzy) with loading animation
             std::string query = argv[3];
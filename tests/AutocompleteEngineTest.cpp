@@ -0,0 +1,143 @@
+#include "TestHarness.hpp"
+#include "AutocompleteEngine.hpp"
+#include <algorithm>
+
+namespace {
+
+std::vector<Symbol> fileSymbols(const std::string& file, const std::string& prefix, int count) {
+    std::vector<Symbol> symbols;
+    for (int i = 0; i < count; i++) {
+        symbols.emplace_back(prefix + std::to_string(i), SymbolType::FUNCTION, file, i + 1);
+    }
+    return symbols;
+}
+
+void makeQuiet(AutocompleteEngine& engine) {
+    engine.setVerbose(false);
+    engine.setThreadCount(1);
+}
+
+// Files of the exact-prefix matches for a name, sorted
+std::vector<std::string> filesOf(const AutocompleteEngine& engine, const std::string& name) {
+    std::vector<std::string> files;
+    for (const auto& result : engine.getPrefixMatches(name, 100)) {
+        if (result.suggestion == name) {
+            files.push_back(result.file);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+TEST(removeFileTombstonesItsSymbols) {
+    AutocompleteEngine engine;
+    makeQuiet(engine);
+    std::vector<Symbol> symbols = fileSymbols("/a.cpp", "alphaFn", 3);
+    std::vector<Symbol> others = fileSymbols("/b.cpp", "betaFn", 2);
+    symbols.insert(symbols.end(), others.begin(), others.end());
+    engine.buildIndex(symbols);
+    CHECK_EQUAL(engine.getSymbolCount(), 5u);
+
+    CHECK_EQUAL(engine.removeFile("/a.cpp"), 3u);
+    CHECK_EQUAL(engine.removeFile("/a.cpp"), 0u);
+    CHECK_EQUAL(engine.getSymbolCount(), 2u);
+    CHECK(engine.getPrefixMatches("alphafn", 10).empty());
+    CHECK(filesOf(engine, "betaFn1") == std::vector<std::string>{"/b.cpp"});
+}
+
+TEST(updateFileReplacesItsSymbols) {
+    AutocompleteEngine engine;
+    makeQuiet(engine);
+    engine.buildIndex(fileSymbols("/a.cpp", "oldName", 2));
+
+    engine.updateFile("/a.cpp", fileSymbols("/a.cpp", "newName", 4));
+    CHECK_EQUAL(engine.getSymbolCount(), 4u);
+    CHECK(engine.getPrefixMatches("oldname", 10).empty());
+    CHECK_EQUAL(engine.getPrefixMatches("newname", 10).size(), 4u);
+}
+
+TEST(compactionKeepsLiveSymbolsQueryable) {
+    AutocompleteEngine engine;
+    makeQuiet(engine);
+    std::vector<Symbol> symbols = fileSymbols("/keep.cpp", "keeper", 10);
+    for (int file = 0; file < 10; file++) {
+        std::vector<Symbol> more = fileSymbols("/drop" + std::to_string(file) + ".cpp", "dropped", 500);
+        symbols.insert(symbols.end(), more.begin(), more.end());
+    }
+    engine.buildIndex(symbols);
+
+    // Enough tombstones to pass CHUNK_SIZE and half the store
+    for (int file = 0; file < 10; file++) {
+        engine.removeFile("/drop" + std::to_string(file) + ".cpp");
+    }
+    CHECK_EQUAL(engine.getSymbolCount(), 10u);
+    CHECK(engine.getPrefixMatches("dropped", 10).empty());
+    CHECK(filesOf(engine, "keeper7") == std::vector<std::string>{"/keep.cpp"});
+
+    // The renumbered symbols are still tracked by file
+    CHECK_EQUAL(engine.removeFile("/keep.cpp"), 10u);
+    CHECK_EQUAL(engine.getSymbolCount(), 0u);
+}
+
+TEST(renameMovesSymbolsToTheNewPath) {
+    AutocompleteEngine engine;
+    makeQuiet(engine);
+    engine.buildIndex(fileSymbols("/old.cpp", "movedFn", 3));
+
+    CHECK_EQUAL(engine.renameFile("/old.cpp", "/new.cpp"), 3u);
+    CHECK_EQUAL(engine.renameFile("/old.cpp", "/other.cpp"), 0u);
+    CHECK_EQUAL(engine.renameFile("/new.cpp", "/new.cpp"), 3u);
+    CHECK(filesOf(engine, "movedFn2") == std::vector<std::string>{"/new.cpp"});
+    CHECK_EQUAL(engine.removeFile("/old.cpp"), 0u);
+    CHECK_EQUAL(engine.removeFile("/new.cpp"), 3u);
+}
+
+TEST(renameOverAFileThatTriggersCompaction) {
+    AutocompleteEngine engine;
+    makeQuiet(engine);
+    std::vector<Symbol> symbols = fileSymbols("/big.cpp", "bigFn", 5000);
+    std::vector<Symbol> moved = fileSymbols("/old.cpp", "movedFn", 10);
+    symbols.insert(symbols.end(), moved.begin(), moved.end());
+    engine.buildIndex(symbols);
+
+    // Replacing big.cpp leaves 5000 tombstones, so the store compacts and
+    // renumbers old.cpp's symbols mid-rename
+    CHECK_EQUAL(engine.renameFile("/old.cpp", "/big.cpp"), 10u);
+    CHECK_EQUAL(engine.getSymbolCount(), 10u);
+    CHECK(engine.getPrefixMatches("bigfn", 10).empty());
+    CHECK(filesOf(engine, "movedFn0") == std::vector<std::string>{"/big.cpp"});
+    CHECK(filesOf(engine, "movedFn9") == std::vector<std::string>{"/big.cpp"});
+    CHECK_EQUAL(engine.removeFile("/old.cpp"), 0u);
+    CHECK_EQUAL(engine.removeFile("/big.cpp"), 10u);
+}
+
+TEST(typoPassDoesNotDependOnThreadCount) {
+    std::vector<Symbol> symbols;
+    for (int file = 0; file < 20; file++) {
+        std::vector<Symbol> more = fileSymbols("/f" + std::to_string(file) + ".cpp", "processRequest", 3000);
+        symbols.insert(symbols.end(), more.begin(), more.end());
+    }
+
+    // "prcoess" is not a subsequence of any name, so only the typo pass finds them
+    std::vector<std::vector<double>> scores;
+    for (size_t threads : {1u, 4u}) {
+        AutocompleteEngine engine;
+        engine.setVerbose(false);
+        engine.setThreadCount(threads);
+        engine.setParallelThreshold(1000);
+        engine.buildIndex(symbols);
+        
+        std::vector<double> run;
+        for (const auto& result : engine.getCompletions("prcoessRequest", 10)) {
+            CHECK_EQUAL(result.matchType, "fuzzy");
+            run.push_back(result.score);
+        }
+        scores.push_back(run);
+    }
+    CHECK(!scores[0].empty());
+    CHECK(scores[0] == scores[1]);
+}
+
+NAVIX_TEST_MAIN()
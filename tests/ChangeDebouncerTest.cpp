@@ -0,0 +1,122 @@
+#include "TestHarness.hpp"
+#include "FileWatcher.hpp"
+#include <algorithm>
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = ChangeDebouncer::Clock;
+
+std::string describe(const FileChange& change) {
+    switch (change.event) {
+        case FileEvent::CREATED: return "created " + change.path;
+        case FileEvent::MODIFIED: return "modified " + change.path;
+        case FileEvent::DELETED: return "deleted " + change.path;
+        case FileEvent::MOVED: return "moved " + change.oldPath + " -> " + change.path;
+    }
+    return "";
+}
+
+std::vector<std::string> describeAll(const std::vector<FileChange>& changes) {
+    std::vector<std::string> lines;
+    for (const FileChange& change : changes) {
+        lines.push_back(describe(change));
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(holdsChangesForTheWindow) {
+    ChangeDebouncer debouncer(100ms, 10ms);
+    auto start = Clock::now();
+    debouncer.add("/a.cpp", FileEvent::MODIFIED, start);
+    debouncer.add("/a.cpp", FileEvent::MODIFIED, start + 20ms);
+    CHECK_EQUAL(debouncer.getCoalescedCount(), 1u);
+
+    CHECK(debouncer.collectReady(start + 60ms).empty());
+    CHECK(debouncer.hasPending());
+    CHECK(describeAll(debouncer.collectReady(start + 300ms)) == std::vector<std::string>{"modified /a.cpp"});
+    CHECK(!debouncer.hasPending());
+}
+
+TEST(reArmedPathSurvivesAWheelLap) {
+    // 12 slots of 10ms; the second event pushes the deadline past one revolution,
+    // so its slot is visited once before the path is due
+    ChangeDebouncer debouncer(100ms, 10ms);
+    auto start = Clock::now();
+    debouncer.add("/a.cpp", FileEvent::MODIFIED, start);
+    debouncer.add("/b.cpp", FileEvent::MODIFIED, start);
+    debouncer.add("/a.cpp", FileEvent::MODIFIED, start + 150ms);
+
+    CHECK(describeAll(debouncer.collectReady(start + 150ms)) == std::vector<std::string>{"modified /b.cpp"});
+    CHECK_EQUAL(debouncer.getPendingCount(), 1u);
+
+    CHECK(debouncer.collectReady(start + 200ms).empty());
+    CHECK(describeAll(debouncer.collectReady(start + 300ms)) == std::vector<std::string>{"modified /a.cpp"});
+    CHECK(!debouncer.hasPending());
+    CHECK(debouncer.flushAll().empty());
+}
+
+TEST(createThenDeleteCancelsOut) {
+    ChangeDebouncer debouncer(100ms, 10ms);
+    auto start = Clock::now();
+    debouncer.add("/tmp.cpp", FileEvent::CREATED, start);
+    debouncer.add("/tmp.cpp", FileEvent::MODIFIED, start + 5ms);
+    debouncer.add("/tmp.cpp", FileEvent::DELETED, start + 10ms);
+    CHECK(debouncer.collectReady(start + 300ms).empty());
+    CHECK(!debouncer.hasPending());
+
+    // The other way round the file still exists, with new content
+    debouncer.add("/kept.cpp", FileEvent::DELETED, start);
+    debouncer.add("/kept.cpp", FileEvent::CREATED, start + 5ms);
+    CHECK(describeAll(debouncer.flushAll()) == std::vector<std::string>{"modified /kept.cpp"});
+}
+
+TEST(movesCoalesceWithPendingChanges) {
+    ChangeDebouncer debouncer(100ms, 10ms);
+    auto start = Clock::now();
+
+    // A plain rename relocates without a reparse
+    debouncer.addMove("/a.cpp", "/b.cpp", start);
+    CHECK(describeAll(debouncer.flushAll()) == std::vector<std::string>{"moved /a.cpp -> /b.cpp"});
+
+    // Edited before the rename: relocate, then reparse
+    debouncer.add("/a.cpp", FileEvent::MODIFIED, start);
+    debouncer.addMove("/a.cpp", "/b.cpp", start + 5ms);
+    CHECK(describeAll(debouncer.flushAll()) ==
+          (std::vector<std::string>{"moved /a.cpp -> /b.cpp", "modified /b.cpp"}));
+
+    // Created in the window: only the final path exists
+    debouncer.add("/new.cpp", FileEvent::CREATED, start);
+    debouncer.addMove("/new.cpp", "/final.cpp", start + 5ms);
+    CHECK(describeAll(debouncer.flushAll()) == std::vector<std::string>{"created /final.cpp"});
+
+    // Chained renames collapse, and one back to the origin is a modification
+    debouncer.addMove("/a.cpp", "/b.cpp", start);
+    debouncer.addMove("/b.cpp", "/c.cpp", start + 5ms);
+    debouncer.addMove("/x.cpp", "/y.cpp", start);
+    debouncer.addMove("/y.cpp", "/x.cpp", start + 5ms);
+    std::vector<std::string> lines = describeAll(debouncer.collectReady(start + 300ms));
+    std::sort(lines.begin(), lines.end());
+    CHECK(lines == (std::vector<std::string>{"modified /x.cpp", "moved /a.cpp -> /c.cpp"}));
+
+    // Renamed then deleted: the original path is gone
+    debouncer.addMove("/a.cpp", "/b.cpp", start);
+    debouncer.add("/b.cpp", FileEvent::DELETED, start + 5ms);
+    CHECK(describeAll(debouncer.flushAll()) == std::vector<std::string>{"deleted /a.cpp"});
+}
+
+TEST(setWindowKeepsPendingChanges) {
+    ChangeDebouncer debouncer(100ms, 10ms);
+    debouncer.add("/a.cpp", FileEvent::CREATED, Clock::now());
+    debouncer.addMove("/b.cpp", "/c.cpp", Clock::now());
+
+    debouncer.setWindow(20ms);
+    CHECK_EQUAL(debouncer.getPendingCount(), 2u);
+    std::vector<std::string> lines = describeAll(debouncer.collectReady(Clock::now() + 100ms));
+    std::sort(lines.begin(), lines.end());
+    CHECK(lines == (std::vector<std::string>{"created /a.cpp", "moved /b.cpp -> /c.cpp"}));
+}
+
+NAVIX_TEST_MAIN()
@@ -0,0 +1,156 @@
+#include "TestHarness.hpp"
+#include "DocumentStore.hpp"
+#include <random>
+
+namespace {
+
+// Byte offset of an LSP position in plain UTF-8 text, clamped the same way
+// TextDocument clamps: past the last line to the end, past a line's end to
+// its line break
+size_t modelOffset(const std::string& text, int line, int character) {
+    size_t offset = 0;
+    for (int i = 0; i < line; i++) {
+        size_t newline = text.find('\n', offset);
+        if (newline == std::string::npos) {
+            return text.size();
+        }
+        offset = newline + 1;
+    }
+
+    int units = 0;
+    while (units < character && offset < text.size() && text[offset] != '\n') {
+        unsigned char c = static_cast<unsigned char>(text[offset]);
+        size_t bytes = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        units += bytes == 4 ? 2 : 1;
+        offset += bytes;
+    }
+    return offset;
+}
+
+void modelReplace(std::string& text, int startLine, int startCharacter, int endLine, int endCharacter,
+                  const std::string& insert) {
+    size_t start = modelOffset(text, startLine, startCharacter);
+    size_t end = modelOffset(text, endLine, endCharacter);
+    text.replace(start, end - start, insert);
+}
+
+} // namespace
+
+TEST(replaceUsesUtf16Characters) {
+    // é is one UTF-16 unit in two bytes, 𝄞 is a surrogate pair in four
+    TextDocument document("caf\xC3\xA9 \xF0\x9D\x84\x9E clef\nsecond line\n", 1);
+
+    document.replace(0, 8, 0, 12, "key");
+    CHECK_EQUAL(document.getLine(0), "caf\xC3\xA9 \xF0\x9D\x84\x9E key");
+
+    document.replace(0, 5, 0, 7, "G");
+    CHECK_EQUAL(document.getLine(0), "caf\xC3\xA9 G key");
+
+    document.replace(0, 3, 0, 4, "e");
+    CHECK_EQUAL(document.getText(), "cafe G key\nsecond line\n");
+    CHECK_EQUAL(document.length(), document.getText().size());
+}
+
+TEST(editsSpanningLines) {
+    TextDocument document("one\ntwo\nthree\n", 1);
+
+    document.replace(0, 2, 2, 1, "-");
+    CHECK_EQUAL(document.getText(), "on-hree\n");
+
+    document.replace(1, 0, 1, 0, "four\nfive");
+    CHECK_EQUAL(document.getText(), "on-hree\nfour\nfive");
+    CHECK_EQUAL(document.getLine(1), "four");
+    CHECK_EQUAL(document.getLine(2), "five");
+}
+
+TEST(positionsClamp) {
+    TextDocument document("ab\ncd", 1);
+
+    // Past the end of a line stops at its line break
+    document.replace(0, 50, 0, 80, "!");
+    CHECK_EQUAL(document.getText(), "ab!\ncd");
+
+    // Past the last line appends
+    document.replace(9, 0, 9, 0, "?");
+    CHECK_EQUAL(document.getText(), "ab!\ncd?");
+
+    CHECK_EQUAL(document.getLine(1), "cd?");
+    CHECK_EQUAL(document.getLine(5), "");
+}
+
+TEST(randomEditsMatchAStringModel) {
+    const std::vector<std::string> fragments = {
+        "x", "yz", "\n", "caf\xC3\xA9", "\xF0\x9D\x84\x9E", "line\nbreak", "", "\n\n", "\xE2\x82\xAC"};
+    std::mt19937 random(42);
+    std::string model = "int main() {\n    return 0;\n}\n";
+    TextDocument document(model, 1);
+
+    for (int step = 0; step < 3000; step++) {
+        int startLine = static_cast<int>(random() % 8);
+        int startCharacter = static_cast<int>(random() % 14);
+        int endLine = startLine + static_cast<int>(random() % 2);
+        int endCharacter = endLine == startLine ? startCharacter + static_cast<int>(random() % 4)
+                                                : static_cast<int>(random() % 14);
+        const std::string& insert = fragments[random() % fragments.size()];
+
+        modelReplace(model, startLine, startCharacter, endLine, endCharacter, insert);
+        document.replace(startLine, startCharacter, endLine, endCharacter, insert);
+
+        if (document.getText() != model) {
+            CHECK_EQUAL(document.getText(), model);
+            return;
+        }
+    }
+    CHECK_EQUAL(document.length(), model.size());
+}
+
+TEST(manyEditsCompactThePieceTable) {
+    TextDocument document("", 1);
+    std::string model;
+    for (int i = 0; i < 3000; i++) {
+        // Insert at the front so every edit splits off a new piece
+        document.replace(0, 0, 0, 0, std::to_string(i % 10));
+        model.insert(0, std::to_string(i % 10));
+        CHECK(document.pieceCount() <= 1025);
+    }
+    CHECK_EQUAL(document.getText(), model);
+}
+
+TEST(setTextReplacesEverything) {
+    TextDocument document("old\ntext", 3);
+    document.replace(0, 0, 0, 0, "very ");
+    document.setText("new");
+    CHECK_EQUAL(document.getText(), "new");
+    CHECK_EQUAL(document.pieceCount(), 1u);
+    CHECK_EQUAL(document.length(), 3u);
+    CHECK_EQUAL(document.getVersion(), 3);
+
+    document.setText("");
+    CHECK_EQUAL(document.getText(), "");
+    document.replace(0, 0, 0, 0, "again");
+    CHECK_EQUAL(document.getText(), "again");
+}
+
+TEST(storeTracksOpenDocuments) {
+    DocumentStore store;
+    CHECK(!store.isOpen("/a.cpp"));
+    CHECK(store.find("/a.cpp") == nullptr);
+
+    store.open("/a.cpp", "int a;", 1);
+    store.open("/b.cpp", "int b;", 4);
+    CHECK_EQUAL(store.size(), 2u);
+    CHECK(store.isOpen("/a.cpp"));
+    CHECK_EQUAL(store.find("/b.cpp")->getVersion(), 4);
+
+    // Reopening replaces the buffer
+    store.open("/a.cpp", "int c;", 2);
+    CHECK_EQUAL(store.size(), 2u);
+    CHECK_EQUAL(store.find("/a.cpp")->getText(), "int c;");
+
+    store.close("/a.cpp");
+    store.close("/missing.cpp");
+    CHECK(!store.isOpen("/a.cpp"));
+    CHECK(store.getPaths() == std::vector<std::string>{"/b.cpp"});
+}
+
+NAVIX_TEST_MAIN()
@@ -0,0 +1,136 @@
+#include "TestHarness.hpp"
+#include "IndexSnapshot.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+IndexSnapshot::Entry makeEntry(const std::string& path, const std::string& text, int64_t mtime) {
+    return {{mtime, text.size()}, WorkspaceIndex::FileUpdate::fromText(path, text)};
+}
+
+bool sameUpdate(const WorkspaceIndex::FileUpdate& a, const WorkspaceIndex::FileUpdate& b) {
+    if (a.path != b.path || a.tokens != b.tokens || a.symbols.size() != b.symbols.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.symbols.size(); i++) {
+        const Symbol& x = a.symbols[i];
+        const Symbol& y = b.symbols[i];
+        if (x.name != y.name || x.type != y.type || x.file != y.file || x.line != y.line ||
+            x.context != y.context) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+} // namespace
+
+TEST(saveThenLoadRoundTrips) {
+    navixtest::TempDirectory dir("snapshot");
+    std::string root = dir.path() + "/root";
+    IndexSnapshot snapshot(dir.path(), root);
+
+    IndexSnapshot::Entries entries;
+    entries[root + "/a.cpp"] = makeEntry(root + "/a.cpp", "class Alpha {\n    void run();\n};\n", 100);
+    entries[root + "/src/b.py"] = makeEntry(root + "/src/b.py", "def beta(x):\n    return x\n", 200);
+    entries[root + "/empty.cpp"] = makeEntry(root + "/empty.cpp", "", 300);
+    CHECK(!entries[root + "/a.cpp"].update.symbols.empty());
+    CHECK(snapshot.save(entries));
+
+    IndexSnapshot::Entries loaded;
+    CHECK(snapshot.load(loaded));
+    CHECK_EQUAL(loaded.size(), entries.size());
+    for (const auto& [path, entry] : entries) {
+        auto found = loaded.find(path);
+        CHECK(found != loaded.end());
+        if (found != loaded.end()) {
+            CHECK(found->second.state == entry.state);
+            CHECK(sameUpdate(found->second.update, entry.update));
+        }
+    }
+}
+
+TEST(missingSnapshotLoadsNothing) {
+    navixtest::TempDirectory dir("snapshot");
+    IndexSnapshot snapshot(dir.path(), dir.path());
+    IndexSnapshot::Entries loaded;
+    CHECK(!snapshot.load(loaded));
+    CHECK(loaded.empty());
+}
+
+TEST(corruptSnapshotIsRejected) {
+    navixtest::TempDirectory dir("snapshot");
+    std::string root = dir.path() + "/root";
+    IndexSnapshot snapshot(dir.path(), root);
+
+    IndexSnapshot::Entries entries;
+    entries[root + "/a.cpp"] = makeEntry(root + "/a.cpp", "int alpha() { return 1; }\n", 1);
+    CHECK(snapshot.save(entries));
+
+    std::string path = dir.file("index");
+    std::string data = readFile(path);
+    CHECK(data.size() > 16);
+
+    // A flipped byte in the middle fails the checksum
+    std::string flipped = data;
+    flipped[flipped.size() / 2] ^= 0x20;
+    writeFile(path, flipped);
+    IndexSnapshot::Entries loaded;
+    CHECK(!snapshot.load(loaded));
+    CHECK(loaded.empty());
+
+    // So does a write cut short
+    writeFile(path, data.substr(0, data.size() - 3));
+    CHECK(!snapshot.load(loaded));
+    CHECK(loaded.empty());
+
+    writeFile(path, data);
+    CHECK(snapshot.load(loaded));
+    CHECK_EQUAL(loaded.size(), 1u);
+}
+
+TEST(reconcileKeepsOnlyUnchangedFiles) {
+    IndexSnapshot::Entries entries;
+    entries["/r/same.cpp"] = makeEntry("/r/same.cpp", "int same;\n", 10);
+    entries["/r/touched.cpp"] = makeEntry("/r/touched.cpp", "int touched;\n", 10);
+    entries["/r/deleted.cpp"] = makeEntry("/r/deleted.cpp", "int deleted;\n", 10);
+
+    WatchJournal::FileTable states;
+    states["/r/same.cpp"] = entries["/r/same.cpp"].state;
+    states["/r/touched.cpp"] = {11, entries["/r/touched.cpp"].state.size};
+    states["/r/new.cpp"] = {12, 4};
+
+    std::vector<std::string> files = {"/r/same.cpp", "/r/touched.cpp", "/r/new.cpp"};
+    std::vector<std::string> stale;
+    CHECK(IndexSnapshot::reconcile(entries, files, states, stale));
+
+    std::sort(stale.begin(), stale.end());
+    CHECK(stale == (std::vector<std::string>{"/r/new.cpp", "/r/touched.cpp"}));
+    CHECK_EQUAL(entries.size(), 1u);
+    CHECK(entries.count("/r/same.cpp") == 1);
+}
+
+TEST(reconcileReportsNothingWhenUpToDate) {
+    IndexSnapshot::Entries entries;
+    entries["/r/a.cpp"] = makeEntry("/r/a.cpp", "int a;\n", 5);
+    WatchJournal::FileTable states;
+    states["/r/a.cpp"] = entries["/r/a.cpp"].state;
+
+    std::vector<std::string> stale = {"leftover"};
+    CHECK(!IndexSnapshot::reconcile(entries, {"/r/a.cpp"}, states, stale));
+    CHECK(stale.empty());
+    CHECK_EQUAL(entries.size(), 1u);
+}
+
+NAVIX_TEST_MAIN()
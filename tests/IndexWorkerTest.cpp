@@ -0,0 +1,126 @@
+#include "TestHarness.hpp"
+#include "IndexWorker.hpp"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream(path) << text;
+}
+
+// Symbols of one file whose names start with "fn", sorted
+std::vector<std::string> namesIn(IndexWorker& worker, const std::string& file) {
+    std::vector<std::string> names;
+    auto engine = worker.acquire();
+    for (const auto& result : engine->getCompletions("fn", 100)) {
+        if (result.file == file && result.matchType == "prefix") {
+            names.push_back(result.suggestion);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool waitForGeneration(IndexWorker& worker, uint64_t generation) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (worker.getGeneration() < generation) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+std::vector<Symbol> parse(const std::vector<std::string>& files) {
+    SymbolIndex index;
+    for (const auto& file : files) {
+        index.indexFile(file);
+    }
+    return index.getSymbols();
+}
+
+} // namespace
+
+TEST(modifiedFileKeepsItsChangesWhenMovedInTheSameBatch) {
+    navixtest::TempDirectory dir("indexworker");
+    std::string a = dir.file("a.cpp");
+    std::string b = dir.file("b.cpp");
+    writeFile(a, "void fnAlpha() {}\n");
+
+    IndexWorker worker(2);
+    worker.start(parse({a}));
+
+    // Edited, then renamed before the debounced batch went out
+    writeFile(a, "void fnAlpha() {}\nvoid fnBeta() {}\n");
+    std::filesystem::rename(a, b);
+    worker.submit({FileChange(a, FileEvent::MODIFIED), FileChange(a, b)});
+    CHECK(waitForGeneration(worker, 1));
+
+    CHECK(namesIn(worker, b) == (std::vector<std::string>{"fnAlpha", "fnBeta"}));
+    CHECK(namesIn(worker, a).empty());
+    worker.stop();
+}
+
+TEST(chainedMovesEndAtTheLastPath) {
+    navixtest::TempDirectory dir("indexworker");
+    std::string x = dir.file("x.cpp");
+    std::string y = dir.file("y.cpp");
+    std::string z = dir.file("z.cpp");
+    writeFile(x, "void fnXray() {}\n");
+
+    IndexWorker worker(2);
+    worker.start(parse({x}));
+
+    std::filesystem::rename(x, z);
+    worker.submit({FileChange(x, y), FileChange(y, z)});
+    CHECK(waitForGeneration(worker, 1));
+
+    CHECK(namesIn(worker, z) == std::vector<std::string>{"fnXray"});
+    CHECK(namesIn(worker, x).empty());
+    CHECK(namesIn(worker, y).empty());
+    worker.stop();
+}
+
+TEST(deleteThenCreateInOneBatchReadsTheNewFile) {
+    navixtest::TempDirectory dir("indexworker");
+    std::string a = dir.file("a.cpp");
+    writeFile(a, "void fnOld() {}\n");
+
+    IndexWorker worker(2);
+    worker.start(parse({a}));
+
+    writeFile(a, "void fnNew() {}\n");
+    worker.submit({FileChange(a, FileEvent::DELETED), FileChange(a, FileEvent::CREATED)});
+    CHECK(waitForGeneration(worker, 1));
+
+    CHECK(namesIn(worker, a) == std::vector<std::string>{"fnNew"});
+    worker.stop();
+}
+
+TEST(batchesApplyToBothBuffers) {
+    navixtest::TempDirectory dir("indexworker");
+    std::string a = dir.file("a.cpp");
+    std::string b = dir.file("b.cpp");
+    writeFile(a, "void fnFirst() {}\n");
+    writeFile(b, "void fnOther() {}\n");
+
+    IndexWorker worker(2);
+    worker.start(parse({a, b}));
+
+    // The second batch lands on the buffer the first one was published from
+    writeFile(a, "void fnSecond() {}\n");
+    worker.submit({FileChange(a, FileEvent::MODIFIED)});
+    CHECK(waitForGeneration(worker, 1));
+    std::filesystem::remove(b);
+    worker.submit({FileChange(b, FileEvent::DELETED)});
+    CHECK(waitForGeneration(worker, 2));
+
+    CHECK(namesIn(worker, a) == std::vector<std::string>{"fnSecond"});
+    CHECK(namesIn(worker, b).empty());
+    worker.stop();
+}
+
+NAVIX_TEST_MAIN()
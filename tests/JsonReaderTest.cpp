@@ -0,0 +1,154 @@
+#include "TestHarness.hpp"
+#include "JsonReader.hpp"
+#include "JsonExporter.hpp"
+
+namespace {
+
+bool parses(const std::string& text) {
+    JsonDocument document;
+    return document.parse(text);
+}
+
+} // namespace
+
+TEST(readsNestedMembers) {
+    JsonDocument document;
+    CHECK(document.parse(R"({"jsonrpc": "2.0", "id": 7, "method": "textDocument/definition",
+        "params": {"textDocument": {"uri": "file:///a.cpp"}, "position": {"line": 3, "character": 12}}})"));
+    JsonView root = document.root();
+
+    CHECK(root.isObject());
+    CHECK_EQUAL(root.size(), 4u);
+    CHECK_EQUAL(root["method"].asString(), "textDocument/definition");
+    CHECK_EQUAL(root["params"]["textDocument"]["uri"].asString(), "file:///a.cpp");
+    CHECK_EQUAL(root["params"]["position"]["line"].asInt(), 3);
+    CHECK_EQUAL(root["params"]["position"]["character"].asInt(), 12);
+    CHECK(root["method"].isPlainString());
+    CHECK(root["method"].plainString() == "textDocument/definition");
+}
+
+TEST(missingValuesFallBack) {
+    JsonDocument document;
+    CHECK(document.parse(R"({"a": {"b": null}, "list": []})"));
+    JsonView root = document.root();
+
+    CHECK(!root["missing"].isValid());
+    CHECK(!root["missing"]["deeper"].isValid());
+    CHECK(root["a"]["b"].isNull());
+    CHECK_EQUAL(root["a"]["b"].asString("fallback"), "fallback");
+    CHECK_EQUAL(root["missing"].asInt(-1), -1);
+    CHECK_EQUAL(root["a"].asBool(true), true);
+    CHECK(!root["list"].at(0).isValid());
+    CHECK_EQUAL(root["list"].size(), 0u);
+    CHECK(root["missing"].raw().empty());
+}
+
+TEST(readsArrays) {
+    JsonDocument document;
+    CHECK(document.parse(R"([1, "two", [3, 4], {"five": 5}, true, false, null])"));
+    JsonView root = document.root();
+
+    CHECK(root.isArray());
+    CHECK_EQUAL(root.size(), 7u);
+    CHECK_EQUAL(root.at(0).asInt(), 1);
+    CHECK_EQUAL(root.at(1).asString(), "two");
+    CHECK_EQUAL(root.at(2).at(1).asInt(), 4);
+    CHECK_EQUAL(root.at(3)["five"].asInt(), 5);
+    CHECK_EQUAL(root.at(4).asBool(), true);
+    CHECK_EQUAL(root.at(5).asBool(true), false);
+    CHECK(root.at(6).isNull());
+
+    // forEach visits elements in order, skipping over nested subtrees
+    std::vector<std::string> raws;
+    root.forEach([&raws](JsonView element) { raws.emplace_back(element.raw()); });
+    CHECK_EQUAL(raws.size(), 7u);
+    CHECK_EQUAL(raws[2], "[3, 4]");
+    CHECK_EQUAL(raws[3], "{\"five\": 5}");
+    CHECK_EQUAL(raws[6], "null");
+}
+
+TEST(decodesEscapes) {
+    JsonDocument document;
+    CHECK(document.parse(R"({"text": "a\"b\\c\/d\n\t", "accent": "caf\u00e9", "clef": "\ud834\udd1E", "k\u0065y": 1})"));
+    JsonView root = document.root();
+
+    CHECK(!root["text"].isPlainString());
+    CHECK_EQUAL(root["text"].asString(), "a\"b\\c/d\n\t");
+    CHECK_EQUAL(root["accent"].asString(), "caf\xC3\xA9");
+    CHECK_EQUAL(root["clef"].asString(), "\xF0\x9D\x84\x9E");
+    // Escaped keys still match their decoded name
+    CHECK_EQUAL(root["key"].asInt(), 1);
+}
+
+TEST(escapedStringsRoundTrip) {
+    // Every control character survives, including those without a short escape
+    std::string value = "tab\tquote\"slash\\ \b\f\x01\x1f end\r\n";
+    std::string json = "{\"v\": \"";
+    JsonExporter::appendEscaped(json, value);
+    json += "\"}";
+    CHECK(json.find("\\u0001") != std::string::npos);
+    CHECK(json.find("\\u001f") != std::string::npos);
+
+    JsonDocument document;
+    CHECK(document.parse(json));
+    CHECK_EQUAL(document.root()["v"].asString(), value);
+}
+
+TEST(readsNumbers) {
+    JsonDocument document;
+    CHECK(document.parse(R"([0, -12, 9007199254740993, 1.5e3, -0.25])"));
+    JsonView root = document.root();
+
+    CHECK_EQUAL(root.at(0).asInt(-1), 0);
+    CHECK_EQUAL(root.at(1).asInt(), -12);
+    CHECK_EQUAL(root.at(2).asInt(), 9007199254740993);
+    CHECK(root.at(3).isNumber());
+    CHECK(root.at(3).raw() == "1.5e3");
+    CHECK(root.at(4).raw() == "-0.25");
+    CHECK_EQUAL(root.at(1).asString("none"), "none");
+}
+
+TEST(rawEchoesIdsUnchanged) {
+    // Ids go back to the client byte for byte, whatever their type
+    JsonDocument numeric;
+    CHECK(numeric.parse(R"({"id": 12345678901234567890, "method": "x"})"));
+    CHECK(numeric.root()["id"].raw() == "12345678901234567890");
+
+    JsonDocument text;
+    CHECK(text.parse(R"({"id": "req-\"7\"", "method": "x"})"));
+    CHECK(text.root()["id"].raw() == R"("req-\"7\"")");
+    CHECK_EQUAL(text.root()["id"].asString(), "req-\"7\"");
+
+    JsonDocument empty;
+    CHECK(empty.parse(R"({"id":""})"));
+    CHECK(empty.root()["id"].raw() == "\"\"");
+}
+
+TEST(rejectsMalformedInput) {
+    CHECK(!parses(""));
+    CHECK(!parses("{"));
+    CHECK(!parses("{\"a\": }"));
+    CHECK(!parses("{\"a\" 1}"));
+    CHECK(!parses("{\"a\": 1,}"));
+    CHECK(!parses("[1 2]"));
+    CHECK(!parses("\"unterminated"));
+    CHECK(!parses("tru"));
+    CHECK(!parses("nul"));
+    CHECK(!parses("{} trailing"));
+
+    JsonDocument document;
+    CHECK(!document.parse("{\"a\": ]"));
+    CHECK(!document.getError().empty());
+}
+
+TEST(limitsNestingDepth) {
+    std::string shallow = std::string(100, '[') + std::string(100, ']');
+    CHECK(parses(shallow));
+
+    std::string deep = std::string(100000, '[') + std::string(100000, ']');
+    JsonDocument document;
+    CHECK(!document.parse(deep));
+    CHECK(!document.getError().empty());
+}
+
+NAVIX_TEST_MAIN()
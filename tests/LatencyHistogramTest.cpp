@@ -0,0 +1,126 @@
+#include "TestHarness.hpp"
+#include "LatencyHistogram.hpp"
+
+using std::chrono::microseconds;
+
+namespace {
+
+// Upper edge of the bucket a value falls in: the lowest percentile of a
+// histogram that also holds a much larger value
+uint64_t bucketEdge(uint64_t value) {
+    LatencyHistogram histogram;
+    histogram.record(microseconds(value));
+    histogram.record(microseconds(uint64_t(1) << 36));
+    return histogram.getPercentile(0.0).count();
+}
+
+} // namespace
+
+TEST(emptyHistogramReportsZero) {
+    LatencyHistogram histogram;
+    CHECK_EQUAL(histogram.getCount(), 0u);
+    CHECK_EQUAL(histogram.getMin().count(), 0);
+    CHECK_EQUAL(histogram.getMax().count(), 0);
+    CHECK_EQUAL(histogram.getMean().count(), 0);
+    CHECK_EQUAL(histogram.getPercentile(0.99).count(), 0);
+}
+
+TEST(smallValuesAreExact) {
+    for (uint64_t value = 0; value < 64; value++) {
+        CHECK_EQUAL(bucketEdge(value), value);
+    }
+}
+
+TEST(largeValuesStayWithinOneThirtySecond) {
+    for (uint64_t value = 64; value < (uint64_t(1) << 30); value = value * 17 / 16 + 1) {
+        uint64_t edge = bucketEdge(value);
+        CHECK(edge >= value);
+        CHECK(edge - value <= value / 32);
+    }
+}
+
+TEST(bucketEdgesAreContiguous) {
+    // The value right after an edge opens the next bucket
+    for (uint64_t value = 64; value < 100000; value = bucketEdge(value) + 1) {
+        uint64_t edge = bucketEdge(value);
+        CHECK(edge >= value);
+        CHECK(bucketEdge(edge) == edge);
+        CHECK(bucketEdge(edge + 1) > edge);
+    }
+}
+
+TEST(percentilesWalkTheDistribution) {
+    LatencyHistogram histogram;
+    for (int value = 1; value <= 100; value++) {
+        histogram.record(microseconds(value));
+    }
+    CHECK_EQUAL(histogram.getCount(), 100u);
+    CHECK_EQUAL(histogram.getMin().count(), 1);
+    CHECK_EQUAL(histogram.getMax().count(), 100);
+    CHECK_EQUAL(histogram.getMean().count(), 50);
+    CHECK_EQUAL(histogram.getPercentile(0.5).count(), 50);
+    CHECK_EQUAL(histogram.getPercentile(0.0).count(), 1);
+    CHECK_EQUAL(histogram.getPercentile(-1.0).count(), 1);
+    // 99 shares a bucket with 98; the top is capped at the recorded max
+    CHECK_EQUAL(histogram.getPercentile(0.99).count(), 99);
+    CHECK_EQUAL(histogram.getPercentile(1.0).count(), 100);
+    CHECK_EQUAL(histogram.getPercentile(2.0).count(), 100);
+}
+
+TEST(countAtOrBelowIncludesTheWholeBucket) {
+    LatencyHistogram histogram;
+    histogram.record(microseconds(10));
+    histogram.record(microseconds(1000));
+    histogram.record(microseconds(1005));
+    histogram.record(microseconds(5000));
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(-1)), 0u);
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(9)), 0u);
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(10)), 1u);
+    // 1000 and 1005 land in the same 16us-wide bucket
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(1000)), 3u);
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(4000)), 3u);
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(5000)), 4u);
+}
+
+TEST(mergeAddsCountsAndBounds) {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    first.record(microseconds(20));
+    first.record(microseconds(40));
+    second.record(microseconds(5));
+    second.record(microseconds(3000));
+
+    first.merge(second);
+    CHECK_EQUAL(first.getCount(), 4u);
+    CHECK_EQUAL(first.getMin().count(), 5);
+    CHECK_EQUAL(first.getMax().count(), 3000);
+    CHECK_EQUAL(first.getMean().count(), 766);
+    CHECK_EQUAL(first.getPercentile(0.5).count(), 20);
+
+    // Merging an empty histogram changes nothing
+    first.merge(LatencyHistogram());
+    CHECK_EQUAL(first.getCount(), 4u);
+    CHECK_EQUAL(first.getMin().count(), 5);
+}
+
+TEST(outOfRangeValuesAreClamped) {
+    LatencyHistogram histogram;
+    histogram.record(microseconds(-5));
+    histogram.record(microseconds(INT64_MAX));
+    CHECK_EQUAL(histogram.getCount(), 2u);
+    CHECK_EQUAL(histogram.getMin().count(), 0);
+    CHECK_EQUAL(histogram.getMax().count(), INT64_MAX);
+    CHECK_EQUAL(histogram.getPercentile(1.0).count(), INT64_MAX);
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(INT64_MAX)), 2u);
+}
+
+TEST(resetClearsEverything) {
+    LatencyHistogram histogram;
+    histogram.record(microseconds(123));
+    histogram.reset();
+    CHECK_EQUAL(histogram.getCount(), 0u);
+    CHECK_EQUAL(histogram.getCountAtOrBelow(microseconds(1000)), 0u);
+    CHECK_EQUAL(histogram.getMax().count(), 0);
+}
+
+NAVIX_TEST_MAIN()
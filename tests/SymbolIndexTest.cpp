@@ -0,0 +1,102 @@
+#include "TestHarness.hpp"
+#include "Symbol.hpp"
+
+namespace {
+
+std::vector<Symbol> fileSymbols(const std::string& file, const std::vector<std::string>& names) {
+    std::vector<Symbol> symbols;
+    for (size_t i = 0; i < names.size(); i++) {
+        symbols.emplace_back(names[i], SymbolType::FUNCTION, file, static_cast<int>(i) + 1);
+    }
+    return symbols;
+}
+
+std::vector<std::string> namesOf(SymbolSlice slice) {
+    std::vector<std::string> names;
+    for (const Symbol& symbol : slice) {
+        names.push_back(symbol.name);
+    }
+    return names;
+}
+
+} // namespace
+
+TEST(updateFileReplacesOnlyThatFile) {
+    SymbolIndex index;
+    index.updateFile("/a.cpp", fileSymbols("/a.cpp", {"shared", "alpha"}));
+    index.updateFile("/b.cpp", fileSymbols("/b.cpp", {"beta", "shared"}));
+    index.updateFile("/c.cpp", fileSymbols("/c.cpp", {"gamma"}));
+    CHECK_EQUAL(index.size(), 5u);
+
+    index.updateFile("/a.cpp", fileSymbols("/a.cpp", {"alpha2", "shared", "alpha3"}));
+    CHECK_EQUAL(index.size(), 6u);
+    CHECK(namesOf(index.getFileSymbols("/a.cpp")) == (std::vector<std::string>{"alpha2", "shared", "alpha3"}));
+    CHECK(namesOf(index.getFileSymbols("/b.cpp")) == (std::vector<std::string>{"beta", "shared"}));
+    CHECK(index.exactSearch("alpha").empty());
+
+    // Name lookups still land on the right symbol of every file
+    std::vector<Symbol> shared = index.exactSearch("shared");
+    CHECK_EQUAL(shared.size(), 2u);
+    for (const Symbol& symbol : shared) {
+        CHECK_EQUAL(symbol.name, "shared");
+        CHECK_EQUAL(symbol.line, 2);
+    }
+    CHECK_EQUAL(index.exactSearch("gamma").size(), 1u);
+}
+
+TEST(removeFileKeepsItsId) {
+    SymbolIndex index;
+    index.updateFile("/a.cpp", fileSymbols("/a.cpp", {"alpha"}));
+    index.updateFile("/b.cpp", fileSymbols("/b.cpp", {"beta"}));
+
+    FileId id;
+    CHECK(index.findFileId("/a.cpp", id));
+    CHECK_EQUAL(index.removeFile("/a.cpp"), 1u);
+    CHECK_EQUAL(index.removeFile("/a.cpp"), 0u);
+    CHECK_EQUAL(index.removeFile("/missing.cpp"), 0u);
+    CHECK_EQUAL(index.size(), 1u);
+    CHECK(index.getFileSymbols(id).empty());
+    CHECK(index.exactSearch("alpha").empty());
+    CHECK_EQUAL(index.exactSearch("beta").size(), 1u);
+
+    // Re-adding reuses the id
+    index.updateFile("/a.cpp", fileSymbols("/a.cpp", {"again"}));
+    FileId reused;
+    CHECK(index.findFileId("/a.cpp", reused));
+    CHECK_EQUAL(reused, id);
+    CHECK_EQUAL(index.getFileCount(), 2u);
+    CHECK_EQUAL(index.getFilePath(id), "/a.cpp");
+}
+
+TEST(addSymbolGroupsByFile) {
+    SymbolIndex index;
+    index.addSymbol(Symbol("one", SymbolType::FUNCTION, "/a.cpp", 1));
+    index.addSymbol(Symbol("two", SymbolType::FUNCTION, "/b.cpp", 1));
+    index.addSymbol(Symbol("three", SymbolType::FUNCTION, "/a.cpp", 2));
+
+    CHECK(namesOf(index.getFileSymbols("/a.cpp")) == (std::vector<std::string>{"one", "three"}));
+    CHECK_EQUAL(index.exactSearch("three").size(), 1u);
+    CHECK_EQUAL(index.exactSearch("three")[0].line, 2);
+
+    std::vector<Symbol> all = index.getSymbols();
+    CHECK_EQUAL(all.size(), 3u);
+    CHECK_EQUAL(all[0].name, "one");
+    CHECK_EQUAL(all[1].name, "three");
+    CHECK_EQUAL(all[2].name, "two");
+}
+
+TEST(indexTextParsesIntoTheFile) {
+    SymbolIndex index;
+    index.indexText("/a.cpp", "class Widget {\n};\nvoid render() {}\n");
+    CHECK(index.size() >= 2u);
+    CHECK_EQUAL(index.exactSearch("Widget").size(), 1u);
+    CHECK_EQUAL(index.exactSearch("render").size(), 1u);
+    CHECK_EQUAL(index.getFileSymbols("/a.cpp").size(), index.size());
+
+    index.clear();
+    CHECK_EQUAL(index.size(), 0u);
+    CHECK_EQUAL(index.getFileCount(), 0u);
+    CHECK(index.exactSearch("Widget").empty());
+}
+
+NAVIX_TEST_MAIN()
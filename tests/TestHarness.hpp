@@ -0,0 +1,109 @@
+#ifndef TESTHARNESS_HPP
+#define TESTHARNESS_HPP
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+#include <unistd.h>
+
+// Just enough of a test runner to keep the tests free of dependencies.
+// TEST(name) registers a case; CHECK and CHECK_EQUAL report a failure and
+// let the case carry on, so one run shows every broken expectation.
+// Each test file ends with NAVIX_TEST_MAIN().
+namespace navixtest {
+
+struct Case {
+    const char* name;
+    void (*run)();
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registration {
+    Registration(const char* name, void (*run)()) { cases().push_back({name, run}); }
+};
+
+inline void fail(const char* file, int line, const std::string& message) {
+    std::cerr << file << ":" << line << ": " << message << "\n";
+    failures()++;
+}
+
+template <typename Actual, typename Expected>
+void checkEqual(const Actual& actual, const Expected& expected, const char* actualText,
+                const char* expectedText, const char* file, int line) {
+    if (!(actual == expected)) {
+        std::ostringstream message;
+        message << actualText << " == " << expectedText << " failed: got " << actual << ", expected " << expected;
+        fail(file, line, message.str());
+    }
+}
+
+inline int runAll() {
+    for (const Case& test : cases()) {
+        int before = failures();
+        test.run();
+        std::cout << (failures() == before ? "[ OK ] " : "[FAIL] ") << test.name << "\n";
+    }
+    std::cout << cases().size() << " tests, " << failures() << " failed checks\n";
+    return failures() == 0 ? 0 : 1;
+}
+
+// A fresh directory under the system temp dir, removed again on destruction
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& name)
+        : m_path((std::filesystem::temp_directory_path() /
+                  ("navix-" + name + "-" + std::to_string(::getpid()))).string())
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(m_path, ec);
+        std::filesystem::create_directories(m_path, ec);
+    }
+
+    ~TempDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(m_path, ec);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    const std::string& path() const { return m_path; }
+    std::string file(const std::string& name) const { return m_path + "/" + name; }
+
+private:
+    std::string m_path;
+};
+
+} // namespace navixtest
+
+#define TEST(name)                                                            \
+    static void name();                                                       \
+    static navixtest::Registration name##Registration(#name, name);           \
+    static void name()
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            navixtest::fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+    navixtest::checkEqual((actual), (expected), #actual, #expected, __FILE__, __LINE__)
+
+#define NAVIX_TEST_MAIN() \
+    int main() { return navixtest::runAll(); }
+
+#endif // TESTHARNESS_HPP